@@ -0,0 +1,126 @@
+"""
+Generates binary panel configurations for EncoderTool::PanelConfig (see src/Multiplexed/PanelConfig.h)
+
+usage: python panelconfig.py panel.json [-o panel.bin] [--header panel.h] [--name panelConfig] [--counter-bits 16]
+
+panel.json:
+{
+    "profiles": {
+        "volume": {"limits": [0, 100], "acceleration": "medium"},
+        "menu":   {"countMode": "half", "limits": [0, 9], "periodic": true}
+    },
+    "channels": ["volume", "volume", "volume", "menu"]
+}
+
+Profile keys (all optional): countMode, limits [min, max], periodic, stepSize, acceleration,
+detents, detentHysteresis, reversalHysteresis, outputMode, decayShift
+Enum names are case insensitive. Without countMode the channels keep the count mode passed to begin().
+Limits and step size need to fit the counter type of the target (--counter-bits, default 32, 16 for int on AVR).
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+VERSION = 1
+
+COUNT_MODES   = ["quarter", "quarterInv", "half", "halfAlt", "full"]
+ACCELERATIONS = ["none", "slow", "medium", "fast"]
+OUTPUT_MODES  = ["position", "velocity", "subStep"]
+KEEP_COUNT_MODE = 0xFF
+
+
+def enumValue(p, key, names, default):
+    value = p.get(key, default)
+    lowered = [n.lower() for n in names]
+    if not isinstance(value, str) or value.lower() not in lowered:
+        raise ValueError("%s: '%s' is not one of %s" % (key, value, ", ".join(names)))
+    return lowered.index(value.lower())
+
+
+def inRange(name, value, lo, hi):
+    if isinstance(value, bool) or not isinstance(value, int) or not lo <= value <= hi:
+        raise ValueError("%s: %s is out of range %d..%d" % (name, value, lo, hi))
+    return value
+
+
+def intValue(p, key, default, lo, hi):
+    return inRange(key, p.get(key, default), lo, hi)
+
+
+def profileRecord(p, counterBits=32):
+    cMin, cMax = -(1 << (counterBits - 1)), (1 << (counterBits - 1)) - 1
+
+    limits = p.get("limits")
+    if limits is not None and (not isinstance(limits, list) or len(limits) != 2):
+        raise ValueError("limits: expected [min, max]")
+    lo = inRange("limits", limits[0], cMin, cMax) if limits else 0
+    hi = inRange("limits", limits[1], cMin, cMax) if limits else 0
+    flags = (1 if limits else 0) | (2 if p.get("periodic", False) else 0)
+
+    countMode = enumValue(p, "countMode", COUNT_MODES, None) if "countMode" in p else KEEP_COUNT_MODE
+    return struct.pack("<8B3i",
+                       countMode,
+                       flags,
+                       enumValue(p, "acceleration", ACCELERATIONS, "none"),
+                       intValue(p, "detents", 1, 1, 255),
+                       intValue(p, "detentHysteresis", 0, 0, 255),
+                       intValue(p, "reversalHysteresis", 0, 0, 255),
+                       enumValue(p, "outputMode", OUTPUT_MODES, "position"),
+                       intValue(p, "decayShift", 10, 0, 31),
+                       lo, hi, intValue(p, "stepSize", 1, 1, cMax))
+
+
+def build(profiles, channels, counterBits=32):
+    names = list(profiles)
+    if not 0 < len(names) < 256 or not 0 < len(channels) < 256:
+        raise ValueError("1..255 profiles and channels supported")
+
+    blob = bytearray(b"EC" + bytes([VERSION, len(names), len(channels)]))
+    for name in names:
+        try:
+            blob += profileRecord(profiles[name], counterBits)
+        except ValueError as e:
+            raise ValueError("profile '%s': %s" % (name, e))
+    for c in channels:
+        if c not in names:
+            raise ValueError("channel uses undefined profile '%s'" % c)
+    blob += bytes(names.index(c) for c in channels)
+    blob.append(-sum(blob) & 0xFF)  # checksum, sum of all bytes == 0
+    return bytes(blob)
+
+
+def cHeader(blob, name):
+    lines = ["// generated by panelconfig.py, do not edit", "#pragma once", "", "#include <Arduino.h>", "",
+             "const uint8_t %s[] PROGMEM = {" % name]
+    for i in range(0, len(blob), 16):
+        lines.append("    " + ", ".join("0x%02X" % b for b in blob[i:i + 16]) + ",")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="EncoderTool panel configuration generator")
+    parser.add_argument("config", help="json description of the panel")
+    parser.add_argument("-o", "--output", help="binary output file")
+    parser.add_argument("--header", help="C header output file (PROGMEM array)")
+    parser.add_argument("--name", default="panelConfig", help="name of the array in the header")
+    parser.add_argument("--counter-bits", type=int, choices=[16, 32], default=32, help="width of the counter type (16: int on AVR)")
+    args = parser.parse_args()
+
+    with open(args.config) as f:
+        cfg = json.load(f)
+    try:
+        blob = build(cfg["profiles"], cfg["channels"], args.counter_bits)
+    except ValueError as e:
+        sys.exit("panelconfig: %s" % e)
+
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(blob)
+    if args.header:
+        with open(args.header, "w") as f:
+            f.write(cHeader(blob, args.name))
+    if not args.output and not args.header:
+        sys.stdout.write(cHeader(blob, args.name))
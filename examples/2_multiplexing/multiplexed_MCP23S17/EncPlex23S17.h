@@ -41,22 +41,28 @@ namespace EncoderTool
             mcp21S17.pinMode(i, INPUT_PULLUP);
             mcp21S17.pinMode(i + 8, INPUT_PULLUP);
         }
+
+        uint16_t data = mcp21S17.readGPIOAB();      // capture start state of all encoders
+        for (unsigned i = 0; i < encoderCount; i++)
+        {
+            encoders[i].begin((data & 1 << i) != 0, (data & 1 << (i + 8)) != 0);
+        }
         isSetup = true;
     }
 
     void EncPlex23S17::tick() // call this as often as possible
     {
-        if (isSetup)  // tick might be called from a timer or yield before it is setup
+        if (isSetup && idleScanDue()) // tick might be called from a timer or yield before it is setup
         {
             uint16_t data = mcp21S17.readGPIOAB();       // read the data from the 23S17 multiplexer
             for (unsigned i = 0; i < encoderCount; i++)  // for all configured encoders
             {                                            // extract the A/B
                 unsigned A = (data & 1 << i) != 0;       //
                 unsigned B = (data & 1 << (i + 8)) != 0; //
-                int delta = encoders[i].update(A, B);    // the base class will take care of the decoding
-
-                if (delta != 0 && callback != nullptr) callback(i, encoders[i].getValue(), delta); // if something changed, invoke the callback
+                process(i, A, B);                        // the base class will take care of the decoding and the callbacks
             }
+            checkIdle();
+            checkFaults();
         }
     }
 } // namespace EncoderTool
\ No newline at end of file
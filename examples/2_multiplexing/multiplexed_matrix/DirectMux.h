@@ -31,10 +31,25 @@ namespace EncoderTool
                 pinMode(pin, OUTPUT);
                 digitalWriteFast(pin, HIGH);  // board is implemented as active LOW
             }
+
+            unsigned curEnc = 0;
+            for (auto cPin : cPins) // capture start state of all encoders
+            {
+                digitalWrite(cPin, LOW);
+                delayNanoseconds(500);
+                for (unsigned row = 0; row < rows; row++)
+                {
+                    encoders[curEnc++].begin(digitalRead(arPins[row]), digitalRead(brPins[row]));
+                }
+                digitalWrite(cPin, HIGH);
+            }
         }
 
         inline void tick() // call as often as possible
         {
+            if (!idleScanDue()) return; // reduced scan rate while idle
+            bool scanButtons = buttonScanDue();
+
             unsigned curEnc = 0;
             for (auto cPin : cPins)
             {
@@ -45,17 +60,17 @@ namespace EncoderTool
                 {
                     uint_fast8_t A = digitalRead(arPins[row]);
                     uint_fast8_t B = digitalRead(brPins[row]);
-                    uint_fast8_t S = digitalRead(srPins[row]);
 
-                    int delta = encoders[curEnc].update(A, B, S);
-                    if (delta != 0 && callback != nullptr)
-                    {
-                        callback(curEnc, encoders[curEnc].getValue(), delta); // if something changed, invoke the callback
-                    }
+                    if (scanButtons)
+                        process(curEnc, A, B, digitalRead(srPins[row])); // decode and invoke callbacks if something changed
+                    else
+                        process(curEnc, A, B);
                     curEnc++;
                 }
                 digitalWrite(cPin, HIGH);
             }
+            checkIdle();
+            checkFaults();
         }
 
      protected:
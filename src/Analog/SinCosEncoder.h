@@ -0,0 +1,153 @@
+#pragma once
+
+#include "../EncoderBase.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Interpolating encoder for analog sin/cos signals (e.g. magnetic
+     *  encoders). The angle of each (sin, cos) ADC sample pair is computed
+     *  by a fixed point CORDIC atan2 (no floating point, no divisions),
+     *  unwrapped across signal periods and fed into the usual value,
+     *  limit and callback machinery of EncoderBase.
+     *
+     *  SinCosEncoder enc;
+     *  enc.setOffsets(2048, 2048).setMinAmplitude(200);   // 12 bit ADC
+     *  enc.begin(analogRead(A0), analogRead(A1), 256);    // 256 counts per signal period
+     *  enc.update(analogRead(A0), analogRead(A1));        // one sample pair
+     *  enc.process(dmaBuffer, 128);                       // 128 interleaved pairs (sin, cos, sin, cos...)
+     *
+     *  Noise at a count boundary toggles the value, use setReversalHysteresis(2)
+     *  or virtual detents to suppress it.
+     ************************************************************************/
+    template <typename counter_t>
+    class SinCosEncoder_tpl : public EncoderBase<counter_t>
+    {
+     public:
+        inline void begin(uint16_t sinSample, uint16_t cosSample, uint16_t countsPerPeriod = 256); // 1 ... 32768 counts per signal period
+        SinCosEncoder_tpl& setOffsets(uint16_t _sinOffset, uint16_t _cosOffset)                      // ADC values at zero signal
+        {
+            sinOffset = _sinOffset;
+            cosOffset = _cosOffset;
+            return *this;
+        }
+        SinCosEncoder_tpl& setMinAmplitude(uint16_t amplitude) // weaker samples (|sin| + |cos|) are ignored and counted as errors
+        {
+            minAmplitude = amplitude;
+            return *this;
+        }
+
+        inline counter_t update(uint16_t sinSample, uint16_t cosSample); // returns the value change
+        inline counter_t process(const uint16_t* samples, size_t pairs); // interleaved buffer, e.g. from an ADC DMA channel
+
+        uint16_t getPeriodAngle() const { return angle; } // angle within the signal period (1/65536 period)
+
+        static inline uint16_t atan2Turns(int32_t y, int32_t x); // angle of (x, y) in 1/65536 turn (error <= 2), |x|, |y| < 2^29
+
+     protected:
+        int32_t sinOffset = 2048, cosOffset = 2048;
+        uint16_t minAmplitude    = 0;
+        uint16_t countsPerPeriod = 256;
+        uint16_t angle           = 0;
+        int32_t fraction         = 0; // position between two counts (1/65536 count)
+
+        static const uint32_t atanTable[16]; // atan(2^-i) in 1/2^24 turn
+    };
+
+    // INLINE IMPLEMENTATION ==========================================================================
+
+    template <typename counter_t>
+    void SinCosEncoder_tpl<counter_t>::begin(uint16_t sinSample, uint16_t cosSample, uint16_t cpp)
+    {
+        countsPerPeriod = cpp == 0 ? 1 : cpp > 32768 ? 32768 : cpp; // fraction += delta * countsPerPeriod must not overflow
+        angle           = atan2Turns(sinSample - sinOffset, cosSample - cosOffset);
+        fraction        = 0;
+    }
+
+    template <typename counter_t>
+    counter_t SinCosEncoder_tpl<counter_t>::update(uint16_t sinSample, uint16_t cosSample)
+    {
+        this->decayVelocity(); // no op if the velocity isn't tracked
+
+        int32_t y = sinSample - sinOffset, x = cosSample - cosOffset;
+        if ((uint32_t)((y < 0 ? -y : y) + (x < 0 ? -x : x)) < minAmplitude) // signal lost
+        {
+            if (this->errCount != 0xFF) this->errCount++;
+            return 0;
+        }
+
+        uint16_t a = atan2Turns(y, x);
+        int16_t d  = (int16_t)(uint16_t)(a - angle); // shortest way, i.e. less than half a period per sample
+        angle      = a;
+
+        fraction += (int32_t)d * countsPerPeriod;
+        int32_t n = fraction >> 16; // whole counts, rounds towards -inf
+        fraction -= n * 65536;
+
+        return n != 0 ? this->reportCounts(n) : 0;
+    }
+
+    template <typename counter_t>
+    counter_t SinCosEncoder_tpl<counter_t>::process(const uint16_t* samples, size_t pairs)
+    {
+        counter_t delta = 0;
+        for (size_t i = 0; i < pairs; i++, samples += 2)
+        {
+            delta += update(samples[0], samples[1]);
+        }
+        return delta;
+    }
+
+    template <typename counter_t>
+    uint16_t SinCosEncoder_tpl<counter_t>::atan2Turns(int32_t y, int32_t x)
+    {
+        uint32_t m = (uint32_t)(x < 0 ? -x : x) | (uint32_t)(y < 0 ? -y : y);
+        if (m == 0) return 0;
+        int32_t scale = 1; // normalize to 2^27 <= max(|x|, |y|) < 2^28, the shifts below lose the precision of small vectors
+        while (m < (UINT32_C(1) << 23))
+        {
+            m <<= 4;
+            scale <<= 4;
+        }
+        while (m < (UINT32_C(1) << 27))
+        {
+            m <<= 1;
+            scale <<= 1;
+        }
+        x *= scale;
+        y *= scale;
+
+        uint32_t z = 0; // 1/2^24 turn
+        if (x < 0)      // rotate by half a turn into the convergence range (+/- 1/4 turn)
+        {
+            x = -x;
+            y = -y;
+            z = UINT32_C(1) << 23;
+        }
+        for (unsigned i = 0; i < 16; i++) // vectoring mode, rotates (x, y) onto the x axis
+        {
+            int32_t xi = x >> i, yi = y >> i;
+            if (y > 0)
+            {
+                x += yi;
+                y -= xi;
+                z += atanTable[i];
+            } else
+            {
+                x -= yi;
+                y += xi;
+                z -= atanTable[i];
+            }
+        }
+        return (uint16_t)((z + 128) >> 8);
+    }
+
+    template <typename counter_t>
+    const uint32_t SinCosEncoder_tpl<counter_t>::atanTable[16]{
+        2097152, 1238021, 654136, 332050, 166669, 83416, 41718, 20860,
+        10430, 5215, 2608, 1304, 652, 326, 163, 81};
+
+    using SinCosEncoder = SinCosEncoder_tpl<int>;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "HAL/SimplyAtomic/SimplyAtomic.h"
+#include "config.h"
+#include <stdint.h>
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Angle and revolutions of a rotary axis, independent of the value,
+     *  step size and limits of the encoder feeding it
+     *
+     *  AngleTracker angle(2400);            // counts per revolution, e.g. 600 ppr in CountMode::full
+     *  encoder.attachAngleTracker(&angle);
+     *  ...
+     *  uint16_t a   = angle.getAngle();     // 1/65536 turn, 16384 = 90°
+     *  int32_t revs = angle.getRevolutions();
+     *
+     *  The position within the revolution is kept in counts and wrapped by
+     *  compare. getAngle() scales it by a 2^32 / cpr factor (one multiply
+     *  and a shift), the only division is done by setCountsPerRevolution().
+     *  Encoders without a tracker only store a null pointer.
+     ************************************************************************/
+    class AngleTracker
+    {
+     public:
+#if defined(USE_MODERN_CALLBACKS)
+        using angleCallback_t = stdext::inplace_function<void(uint16_t angle, int32_t revolutions)>;
+#else
+        using angleCallback_t = void (*)(uint16_t angle, int32_t revolutions);
+#endif
+
+        AngleTracker(uint16_t countsPerRev) { setCountsPerRevolution(countsPerRev); }
+
+        inline AngleTracker& setCountsPerRevolution(uint16_t cpr); // resets angle and revolutions
+        AngleTracker& attachCallback(angleCallback_t cb)           // invoked on each change (from the ISR for interrupt based encoders)
+        {
+            callback = cb;
+            return *this;
+        }
+
+        inline void add(int_fast8_t steps); // called by EncoderBase
+
+        inline uint16_t getAngle() const;      // 1/65536 turn
+        inline int32_t getRevolutions() const; // signed, full turns since reset()
+        inline void reset();                   // current position is angle 0 of revolution 0
+
+     protected:
+        uint16_t countsPerRev    = 1;
+        uint32_t anglePerCount   = 0; // 2^32 / countsPerRev (1/2^32 turn)
+        uint16_t pos             = 0; // position within the revolution in counts
+        int32_t revolutions      = 0;
+        angleCallback_t callback = nullptr;
+    };
+
+    // INLINE IMPLEMENTATION ==========================================================================
+
+    AngleTracker& AngleTracker::setCountsPerRevolution(uint16_t cpr)
+    {
+        ATOMIC()
+        {
+            countsPerRev  = cpr > 1 ? cpr : 1;
+            anglePerCount = cpr > 1 ? (uint32_t)(((UINT64_C(1) << 32) + cpr - 1) / cpr) : 0; // rounded up -> exact angles at multiples of 1/65536 turn
+            pos           = 0;
+            revolutions   = 0;
+        }
+        return *this;
+    }
+
+    void AngleTracker::add(int_fast8_t steps)
+    {
+        const int_fast32_t cpr = countsPerRev;
+
+        int_fast32_t p = pos + steps;
+        while (p >= cpr) // usually at most one iteration
+        {
+            p -= cpr;
+            revolutions++;
+        }
+        while (p < 0)
+        {
+            p += cpr;
+            revolutions--;
+        }
+        pos = p;
+        if (callback != nullptr) callback(getAngle(), revolutions);
+    }
+
+    uint16_t AngleTracker::getAngle() const
+    {
+        uint32_t p;
+        ATOMIC() // 16 bit reads aren't atomic on 8 bit processors
+        {
+            p = pos;
+        }
+        return (uint16_t)((p * anglePerCount) >> 16); // p < countsPerRev, no overflow
+    }
+
+    int32_t AngleTracker::getRevolutions() const
+    {
+        if (sizeof(__SIG_ATOMIC_TYPE__) >= sizeof(int32_t)) // compile time evaluation
+            return revolutions;
+        else
+        {
+            ATOMIC()
+            {
+                return revolutions;
+            }
+        }
+        return revolutions; // make the compiler happy
+    }
+
+    void AngleTracker::reset()
+    {
+        ATOMIC()
+        {
+            pos         = 0;
+            revolutions = 0;
+        }
+    }
+}
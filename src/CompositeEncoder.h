@@ -0,0 +1,112 @@
+#pragma once
+
+#include "EncoderBase.h"
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Virtual encoder combining the steps of several encoders into one
+     *  value. Typical uses are coarse/fine encoder pairs or a shift button
+     *  switching the step size.
+     *
+     *  Each source contributes 'weight' per step, or 'modifiedWeight' while
+     *  the modifier is active. The sources feed their steps directly from
+     *  their update() into the composite which then applies acceleration,
+     *  limits and callbacks to the combined value. The values of the
+     *  sources themselves are counted as usual. Sources detach themselves
+     *  when they are destroyed before the composite.
+     ************************************************************************/
+    template <typename counter_t>
+    class CompositeEncoder_tpl : public EncoderBase<counter_t>
+    {
+     public:
+        static constexpr unsigned maxSources = 4;
+
+        CompositeEncoder_tpl() = default;
+        inline ~CompositeEncoder_tpl();
+
+        inline bool addSource(EncoderBase<counter_t>& source, counter_t weight = 1);
+        inline bool addSource(EncoderBase<counter_t>& source, counter_t weight, counter_t modifiedWeight);
+        inline void removeSource(EncoderBase<counter_t>& source);
+
+        void setModifier(bool active) { modifier = active; } // e.g. from a shift key
+        inline void setModifierButton(EncoderBase<counter_t>& buttonSource, uint8_t activeLevel = 0); // active LOW by default, needs to outlive the composite unless it is a source
+
+     protected:
+        using EncoderBase<counter_t>::update; // a composite is not fed by pins
+        using EncoderBase<counter_t>::begin;
+        using EncoderBase<counter_t>::setCountMode;
+
+        inline void sourceStep(uint8_t slot, int_fast8_t steps);
+
+        EncoderBase<counter_t>* sources[maxSources] = {};
+        counter_t weights[maxSources][2];
+
+        bool modifier                          = false;
+        EncoderBase<counter_t>* modifierButton = nullptr;
+        uint8_t modifierLevel                  = 0;
+
+        friend class EncoderBase<counter_t>;
+    };
+
+    // INLINE IMPLEMENTATION ==========================================================================
+
+    template <typename counter_t>
+    CompositeEncoder_tpl<counter_t>::~CompositeEncoder_tpl()
+    {
+        for (unsigned i = 0; i < maxSources; i++)
+        {
+            if (sources[i] != nullptr) sources[i]->composite = nullptr;
+        }
+    }
+
+    template <typename counter_t>
+    bool CompositeEncoder_tpl<counter_t>::addSource(EncoderBase<counter_t>& source, counter_t weight)
+    {
+        return addSource(source, weight, weight);
+    }
+
+    template <typename counter_t>
+    bool CompositeEncoder_tpl<counter_t>::addSource(EncoderBase<counter_t>& source, counter_t weight, counter_t modifiedWeight)
+    {
+        for (unsigned slot = 0; slot < maxSources; slot++)
+        {
+            if (sources[slot] == nullptr || sources[slot] == &source)
+            {
+                weights[slot][0] = weight;
+                weights[slot][1] = modifiedWeight;
+                sources[slot]    = &source;
+
+                source.compositeSlot = slot;
+                source.composite     = this;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename counter_t>
+    void CompositeEncoder_tpl<counter_t>::removeSource(EncoderBase<counter_t>& source)
+    {
+        if (source.composite != this) return;
+        sources[source.compositeSlot] = nullptr;
+        source.composite              = nullptr;
+    }
+
+    template <typename counter_t>
+    void CompositeEncoder_tpl<counter_t>::setModifierButton(EncoderBase<counter_t>& buttonSource, uint8_t activeLevel)
+    {
+        modifierButton = &buttonSource;
+        modifierLevel  = activeLevel;
+    }
+
+    template <typename counter_t>
+    void CompositeEncoder_tpl<counter_t>::sourceStep(uint8_t slot, int_fast8_t steps)
+    {
+        bool modified    = modifierButton != nullptr ? modifierButton->button.read() == modifierLevel : modifier;
+        counter_t weight = weights[slot][modified];
+        EncoderBase<counter_t>::step(weight * steps);
+    }
+
+    using CompositeEncoder = CompositeEncoder_tpl<int>;
+}
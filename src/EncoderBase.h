@@ -1,8 +1,12 @@
 #pragma once
 
 #include "EncoderButton.h"
+#include "Fixed.h"
+#include "arithmetic.h"
 #include "HAL/SimplyAtomic/SimplyAtomic.h"
-#include "HAL/directReadWrite.h"
+#include "TimeSource.h"
+#include "StepHistory.h"
+#include "AngleTracker.h"
 #include "config.h"
 
 namespace EncoderTool
@@ -15,6 +19,19 @@ namespace EncoderTool
         full               //          4          |       n.a.       | standard for optical encoders w/o detents
     };
 
+    enum class OutputMode {
+        position,          // callback reports the current value (default)
+        velocity,          // callback reports the current velocity (jog / shuttle wheels)
+        subStep            // callback reports the sub step position (4 per count) on each input change
+    };
+
+    enum class LimitMode : uint8_t { // selected by setLimits()
+        unbounded,                   // full range of the counter type, wraps around at the ends
+        clamped,                     // stops at min / max
+        periodic,                    // wraps around from max to min and vice versa
+        periodicPow2                 // periodic with a power of two range (wrap by masking)
+    };
+
     enum class AccelerationMode {
         NONE,              // No acceleration (default)
         SLOW,              // Gentle acceleration for fine control
@@ -22,6 +39,75 @@ namespace EncoderTool
         FAST               // Aggressive acceleration for large value ranges
     };
 
+    template <typename ct>
+    class EncoderBase;
+    template <typename ct>
+    class EncPlexBase;
+    template <typename ct>
+    class CompositeEncoder_tpl;
+    template <typename ct>
+    class Position64_tpl;
+
+    /***********************************************************************
+     *  Configuration (count mode, limits, step size, acceleration, output
+     *  mode, detents, reversal hysteresis) which can be shared by any
+     *  number of encoders, e.g. all channels of a multiplexer:
+     *
+     *  EncoderProfile volume, menu;
+     *  volume.setLimits(0, 100).setAcceleration(AccelerationMode::MEDIUM);
+     *  menu.setCountMode(CountMode::half).setLimits(0, 9, true);
+     *  plex.begin(CountMode::quarter);
+     *  plex.applyProfile(0, 24, volume);  // channels 0..23, keep quarter
+     *  plex.applyProfile(24, 8, menu);    // channels 24..31, half
+     *
+     *  Shared profiles are referenced, not copied, i.e. they need to live
+     *  as long as the encoders and changes apply to all of them. Calling
+     *  a setter of an encoder copies the profile into the encoder.
+     *  The count mode belongs to the encoder, a profile only overrides it
+     *  if setCountMode() was called on the profile (taken over when the
+     *  profile is applied).
+     ************************************************************************/
+    template <typename counter_t>
+    class EncoderProfile_tpl
+    {
+     public:
+        constexpr EncoderProfile_tpl() = default;
+
+        EncoderProfile_tpl& setCountMode(CountMode); // optional, default: keep the count mode of the encoders
+        EncoderProfile_tpl& setLimits(counter_t min, counter_t max, bool periodic = false);
+        EncoderProfile_tpl& setStepSize(counter_t stepSize);
+        EncoderProfile_tpl& setAcceleration(AccelerationMode mode);
+        EncoderProfile_tpl& setOutputMode(OutputMode mode, uint8_t decayShift = 10);
+        EncoderProfile_tpl& setDetents(uint8_t countsPerDetent, uint8_t hysteresis = 0);
+        EncoderProfile_tpl& setReversalHysteresis(uint8_t steps);
+
+        LimitMode getLimitMode() const { return limitMode; }
+
+     protected:
+        using machine_t = const uint8_t (*)[7][4];
+        static constexpr machine_t machineFor(CountMode mode);
+        static constexpr uint8_t invertFor(CountMode mode);
+        inline void selectWrap(); // periodic or periodicPow2, depends on limits and step size
+
+        counter_t minVal       = std::numeric_limits<counter_t>::min();
+        counter_t maxVal       = std::numeric_limits<counter_t>::max();
+        counter_t periodMask   = 0; // maxVal - minVal + stepSize - 1 (periodicPow2 only)
+        counter_t stepSize     = 1;
+        machine_t stateMachine = nullptr; // nullptr: keep the count mode of the encoder
+        uint8_t invert         = 0x00;
+        LimitMode limitMode    = LimitMode::unbounded;
+
+        AccelerationMode accelMode = AccelerationMode::NONE;
+        OutputMode outputMode      = OutputMode::position;
+        uint8_t velocityDecay      = 0; // 0: velocity not tracked
+        uint8_t detentSize = 1, detentThreshold = 0;
+        uint8_t reversalHysteresis = 0;
+
+        friend class EncoderBase<counter_t>;
+        template <typename T>
+        friend class EncPlexBase;
+    };
+
     template <typename ct>
     class EncoderBase
     {
@@ -41,48 +127,110 @@ namespace EncoderTool
         EncoderBase& attachCallback(encCallback_t);
         EncoderBase& attachButtonCallback(encBtnCallback_t);
         EncoderBase& setLimits(counter_t min, counter_t max, bool periodic = false);
+        EncoderBase& setStepSize(counter_t stepSize); // value change per step (before acceleration), default 1
         EncoderBase& setAcceleration(AccelerationMode mode);
+        EncoderBase& setOutputMode(OutputMode mode, uint8_t decayShift = 10);
+        EncoderBase& setDetents(uint8_t countsPerDetent, uint8_t hysteresis = 0); // virtual detents, 1: off
+        EncoderBase& setReversalHysteresis(uint8_t steps);                         // steps needed to report a direction change, 0/1: off
+        EncoderBase& attachHistory(StepHistoryBase* history);                      // records the steps for time window queries, nullptr: off
+        EncoderBase& attachAngleTracker(AngleTracker* tracker);                    // angle and revolutions (independent of value and limits), nullptr: off
+        EncoderBase& setProfile(const EncoderProfile_tpl<counter_t>& profile);     // shared configuration, replaces the settings above
 
         void setValue(counter_t val);
         counter_t getValue() const;
         bool valueChanged();
 
+        counter_t getSubStepPosition() const; // value * 4 + position between the detents in quarter steps (times step size)
+        counter_t getDetent() const;          // virtual detents crossed since setDetents()
+
+        int32_t getVelocity() const; // steps per 2^decayShift ticks, fixed point (1/256 steps), needs OutputMode::velocity
+                                     // the callback reports it in steps, saturated to counter_t (fraction kept for fixed point types)
+        void decayVelocity();        // called once per tick by the polled encoders, interrupt based encoders need to call it periodically
+
         uint8_t getButton();
         bool buttonChanged();
 
-        counter_t update(uint_fast8_t phaseA, uint_fast8_t phaseB, uint_fast8_t btn = 0);
+        counter_t update(uint_fast8_t phaseA, uint_fast8_t phaseB, uint_fast8_t btn); // quadrature and button
+        counter_t update(uint_fast8_t phaseA, uint_fast8_t phaseB);                   // quadrature only
+        void updateButton(uint_fast8_t btn);                                          // e.g. at a lower rate than the quadrature signals
+
+        ~EncoderBase(); // detaches from a composite encoder
 
      protected:
         EncoderBase()                              = default;
         EncoderBase& operator=(EncoderBase const&) = delete;
         EncoderBase(EncoderBase const&)            = delete;
 
-        counter_t value  = 0;
-        counter_t minVal = std::numeric_limits<counter_t>::min();
-        counter_t maxVal = std::numeric_limits<counter_t>::max();
-        bool valChanged  = false;
+        using profile_t = EncoderProfile_tpl<counter_t>;
+        using machine_t = typename profile_t::machine_t;
+        inline profile_t& ownProfile();                       // copies a shared profile into 'settings' (no heap)
+        inline void setMachine(machine_t machine, uint8_t inv); // switches the count mode, keeps the state of the inputs
+
+        profile_t settings;                // used unless a shared profile is set
+        const profile_t* profile = &settings;
+        machine_t stateMachine   = &stateMachineFull;
+        uint8_t invert           = 0x00;
+
+        counter_t value = 0;
+        bool valChanged = false;
 
         EncoderButton button;
         bool btnChanged = false;
 
-        bool periodic   = true;
-        unsigned invert = 0x00;
+        volatile uint8_t carry = 0; // free running count of wraps in unbounded mode, see Position64.h
 
         encCallback_t callback       = nullptr;
         encBtnCallback_t btnCallback = nullptr;
 
         // Acceleration support
-        AccelerationMode accelMode = AccelerationMode::NONE;
         unsigned long lastUpdateTime = 0;
 
         // Helper method for acceleration
         counter_t getAcceleratedDelta(counter_t baseDelta);
 
+        counter_t step(counter_t delta);                  // applies acceleration and limits to the value, invokes callback
+        inline counter_t reportSteps(int_fast8_t steps); // velocity, composite, history and step(), used by all front ends
+        inline counter_t reportCounts(int32_t counts);   // any number of steps (interpolating front ends), reversal filtered
+
+        void notify(counter_t delta)
+        {
+            if (callback == nullptr || profile->outputMode == OutputMode::subStep) return; // sub step output is reported by update()
+            callback(profile->outputMode == OutputMode::velocity ? fromQ8(velocity, counter_t()) : profile->detentSize > 1 ? detent : value, delta); // velocity in steps, saturated
+        }
+
+        static const int8_t subStepQtr[7];  // position of the states between the detents in quarter steps
+        static const int8_t subStepHalf[7];
+        inline int_fast8_t subStepFraction(uint8_t state) const; // 0 at the detents (and always in CountMode::full)
+        counter_t subStepPosition(counter_t val, uint8_t state) const;
+
+        // Velocity output: each step adds 256 to the velocity, each tick (decayVelocity()) removes 1/2^velocityDecay of it
+        // i.e., the velocity is a leaky integrator of the steps with a time constant of 2^velocityDecay ticks
+        inline void addVelocity(int_fast8_t steps);
+        volatile int32_t velocity = 0;
+
+        // Virtual detents: the value keeps the full resolution, callbacks are only invoked if the value moved more than
+        // 'threshold' counts away from the current detent (counts per detent / 2 + hysteresis)
+        inline counter_t crossDetents(counter_t delta); // returns the number of crossed detents
+        counter_t detentOffset = 0; // distance of the value to the current detent
+        counter_t detent       = 0;
+
+        // Reversal hysteresis: steps against the last reported direction are held back until 'reversalHysteresis'
+        // of them are pending, steps in the last direction cancel pending ones (jitter at rest)
+        inline int_fast8_t filterReversal(int_fast8_t direction); // returns the number of steps to report (signed)
+        uint8_t reversalPending = 0;
+        int8_t lastDirection    = 0;
+
+        CompositeEncoder_tpl<counter_t>* composite = nullptr; // composite encoder fed by this encoder (if any)
+        uint8_t compositeSlot                      = 0;
+
+        StepHistoryBase* history   = nullptr;
+        AngleTracker* angleTracker = nullptr;
+
         static const uint8_t stateMachineQtr[7][4];
         static const uint8_t stateMachineHalf[7][4];
         static const uint8_t stateMachineFull[7][4];
-        const uint8_t (*stateMachine)[7][4] = &stateMachineFull;
-        uint8_t curState                    = 0;
+        uint8_t curState = 0;
+        uint8_t errCount = 0; // invalid transitions (saturating), used by the line fault detection of the multiplexers
 
         enum states : uint8_t {
             A     = 0x00,
@@ -100,6 +248,11 @@ namespace EncoderTool
 
         template <typename T>
         friend class EncPlexBase;
+        template <typename T>
+        friend class CompositeEncoder_tpl;
+        template <typename T>
+        friend class Position64_tpl;
+        friend class EncoderProfile_tpl<counter_t>;
 
 #if defined(USE_ERROR_CALLBACKS)
      protected:
@@ -109,11 +262,109 @@ namespace EncoderTool
         void attachErrorCallback(encCallback_t cb) { errCallback = cb; }
 #endif
 
-        static_assert(is_integral<counter_t>::value && is_signed<counter_t>::value, "Only signed integral types allowed");
+        static_assert(std::numeric_limits<counter_t>::is_signed && std::numeric_limits<counter_t>::is_exact, "Only signed integral or fixed point types allowed");
     };
 
     // INLINE IMPLEMENTATION ==========================================================================
 
+    template <typename counter_t>
+    constexpr typename EncoderProfile_tpl<counter_t>::machine_t EncoderProfile_tpl<counter_t>::machineFor(CountMode mode)
+    {
+        return mode == CountMode::quarter || mode == CountMode::quarterInv ? &EncoderBase<counter_t>::stateMachineQtr
+             : mode == CountMode::half || mode == CountMode::halfAlt       ? &EncoderBase<counter_t>::stateMachineHalf
+                                                                           : &EncoderBase<counter_t>::stateMachineFull;
+    }
+
+    template <typename counter_t>
+    constexpr uint8_t EncoderProfile_tpl<counter_t>::invertFor(CountMode mode)
+    {
+        return mode == CountMode::quarter ? 0b11 : mode == CountMode::halfAlt ? 0b01 : 0b00;
+    }
+
+    template <typename counter_t>
+    EncoderProfile_tpl<counter_t>& EncoderProfile_tpl<counter_t>::setCountMode(CountMode mode)
+    {
+        stateMachine = machineFor(mode);
+        invert       = invertFor(mode);
+        return *this;
+    }
+
+    template <typename counter_t>
+    EncoderProfile_tpl<counter_t>& EncoderProfile_tpl<counter_t>::setLimits(counter_t min, counter_t max, bool periodic)
+    {
+        constexpr counter_t typeMin = std::numeric_limits<counter_t>::min();
+        constexpr counter_t typeMax = std::numeric_limits<counter_t>::max();
+
+        if (min >= max || (min == typeMin && max == typeMax)) // invalid or full range
+        {
+            minVal    = typeMin;
+            maxVal    = typeMax;
+            limitMode = LimitMode::unbounded;
+        } else
+        {
+            minVal    = min;
+            maxVal    = max;
+            limitMode = periodic ? LimitMode::periodic : LimitMode::clamped;
+            selectWrap();
+        }
+        return *this;
+    }
+
+    template <typename counter_t>
+    EncoderProfile_tpl<counter_t>& EncoderProfile_tpl<counter_t>::setStepSize(counter_t _stepSize)
+    {
+        stepSize = _stepSize > 0 ? _stepSize : 1;
+        selectWrap(); // the period depends on the step size
+        return *this;
+    }
+
+    template <typename counter_t>
+    void EncoderProfile_tpl<counter_t>::selectWrap()
+    {
+        if (limitMode != LimitMode::periodic && limitMode != LimitMode::periodicPow2) return;
+
+        // a wrap from max to min is one step, i.e. the period is span + stepSize. Periods of 2^n are wrapped by masking
+        counter_t span, period;
+        limitMode = LimitMode::periodic;
+        if (subOverflow(maxVal, minVal, &span)) return;
+        period     = wrappingAdd(span, stepSize); // 2^(bits - 1) wraps to the type minimum, still a power of two
+        periodMask = wrappingSub(period, lsb(period));
+        if (maskBits(period, periodMask) == 0) limitMode = LimitMode::periodicPow2;
+    }
+
+    template <typename counter_t>
+    EncoderProfile_tpl<counter_t>& EncoderProfile_tpl<counter_t>::setAcceleration(AccelerationMode mode)
+    {
+        accelMode = mode;
+        return *this;
+    }
+
+    template <typename counter_t>
+    EncoderProfile_tpl<counter_t>& EncoderProfile_tpl<counter_t>::setOutputMode(OutputMode mode, uint8_t decayShift)
+    {
+        outputMode    = mode;
+        velocityDecay = mode == OutputMode::velocity ? (decayShift > 0 ? decayShift : 1) : 0;
+        return *this;
+    }
+
+    template <typename counter_t>
+    EncoderProfile_tpl<counter_t>& EncoderProfile_tpl<counter_t>::setDetents(uint8_t countsPerDetent, uint8_t hysteresis)
+    {
+        detentSize      = countsPerDetent > 0 ? countsPerDetent : 1;
+        unsigned thresh = detentSize / 2 + hysteresis;
+        detentThreshold = thresh < detentSize ? thresh : detentSize - 1; // at most one full detent away
+        return *this;
+    }
+
+    template <typename counter_t>
+    EncoderProfile_tpl<counter_t>& EncoderProfile_tpl<counter_t>::setReversalHysteresis(uint8_t steps)
+    {
+        reversalHysteresis = steps > 1 ? steps : 0;
+        return *this;
+    }
+
+    // EncoderBase -----------------------------------------------------------------------------------
+
     template <typename counter_t>
     bool EncoderBase<counter_t>::valueChanged()
     {
@@ -137,10 +388,138 @@ namespace EncoderTool
         return value; // make the compiler happy
     }
 
+    template <typename counter_t>
+    int_fast8_t EncoderBase<counter_t>::subStepFraction(uint8_t state) const
+    {
+        if (stateMachine == &stateMachineQtr) return subStepQtr[state];
+        if (stateMachine == &stateMachineHalf) return subStepHalf[state];
+        return 0;
+    }
+
+    template <typename counter_t>
+    counter_t EncoderBase<counter_t>::subStepPosition(counter_t val, uint8_t state) const
+    {
+        int_fast8_t frac = subStepFraction(state);
+        if (profile->limitMode == LimitMode::clamped && ((val == profile->maxVal && frac > 0) || (val == profile->minVal && frac < 0))) frac = 0; // don't report positions beyond the limits
+        return val * 4 + profile->stepSize * frac; // quarter steps in units of the step size
+    }
+
+    template <typename counter_t>
+    counter_t EncoderBase<counter_t>::getSubStepPosition() const
+    {
+        uint8_t state;
+        counter_t val;
+        do // value and state are changed by update() which might run in an ISR -> retry if the state changed while reading
+        {
+            state = curState;
+            val   = getValue();
+        } while (state != curState);
+        return subStepPosition(val, state);
+    }
+
+    template <typename counter_t>
+    counter_t EncoderBase<counter_t>::getDetent() const
+    {
+        if (sizeof(__SIG_ATOMIC_TYPE__) == sizeof(counter_t)) // compile time evaluation
+            return detent;
+        else
+        {
+            ATOMIC()
+            {
+                return detent;
+            }
+        }
+        return detent; // make the compiler happy
+    }
+
+    template <typename counter_t>
+    counter_t EncoderBase<counter_t>::crossDetents(counter_t delta)
+    {
+        const counter_t width     = profile->stepSize * profile->detentSize;
+        const counter_t threshold = profile->stepSize * profile->detentThreshold;
+
+        counter_t offset  = detentOffset + delta;
+        counter_t crossed = 0;
+        while (offset > threshold)
+        {
+            offset  = offset - width;
+            crossed = crossed + 1;
+        }
+        while (offset < -threshold)
+        {
+            offset  = offset + width;
+            crossed = crossed - 1;
+        }
+        detentOffset = offset;
+        detent       = detent + crossed;
+        return crossed;
+    }
+
+    template <typename counter_t>
+    int_fast8_t EncoderBase<counter_t>::filterReversal(int_fast8_t direction)
+    {
+        if (direction == lastDirection)
+        {
+            if (reversalPending == 0) return direction;
+            reversalPending--; // back to where we were
+            return 0;
+        }
+        if (lastDirection != 0 && ++reversalPending < profile->reversalHysteresis) return 0;
+
+        int_fast8_t steps = reversalPending > 0 ? reversalPending : 1;
+        reversalPending   = 0;
+        lastDirection     = direction;
+        return direction > 0 ? steps : -steps;
+    }
+
+    template <typename counter_t>
+    int32_t EncoderBase<counter_t>::getVelocity() const
+    {
+        if (sizeof(__SIG_ATOMIC_TYPE__) >= sizeof(int32_t)) // compile time evaluation
+            return velocity;
+        else
+        {
+            ATOMIC()
+            {
+                return velocity;
+            }
+        }
+        return velocity; // make the compiler happy
+    }
+
+    template <typename counter_t>
+    void EncoderBase<counter_t>::addVelocity(int_fast8_t steps)
+    {
+        constexpr int32_t maxVelocity = INT32_C(1) << 30;
+
+        int32_t v = velocity + steps * 256;
+        velocity  = v > maxVelocity ? maxVelocity : v < -maxVelocity ? -maxVelocity : v;
+    }
+
+    template <typename counter_t>
+    void EncoderBase<counter_t>::decayVelocity()
+    {
+        if (profile->velocityDecay == 0 || velocity == 0) return; // cheap exit for the common case
+
+        bool stopped = false;
+        ATOMIC() // interrupt based encoders add steps from the ISR
+        {
+            int32_t v = velocity;
+            if (v != 0)
+            {
+                int32_t d = v >> profile->velocityDecay; // rounds towards -inf, i.e. small negative values decay by -1
+                velocity  = v - (d != 0 ? d : 1);        // make sure that small positive values reach zero as well
+                stopped   = velocity == 0;
+            }
+        }
+        if (stopped) notify(0); // report stop
+    }
+
     template <typename counter_t>
     void EncoderBase<counter_t>::setValue(counter_t val)
     {
-        value = val;
+        value        = val < profile->minVal ? profile->minVal : val > profile->maxVal ? profile->maxVal : val;
+        detentOffset = 0; // the new value is a detent position
     }
 
     template <typename counter_t>
@@ -160,28 +539,7 @@ namespace EncoderTool
     template <typename counter_t>
     EncoderBase<counter_t>& EncoderBase<counter_t>::setCountMode(CountMode mode)
     {
-        switch (mode)
-        {
-            case CountMode::quarter:
-                stateMachine = &stateMachineQtr;
-                invert       = 0b11;
-                break;
-            case CountMode::quarterInv:
-                stateMachine = &stateMachineQtr;
-                invert       = 0b00;
-                break;
-            case CountMode::half:
-                stateMachine = &stateMachineHalf;
-                invert       = 0b00;
-                break;
-            case CountMode::halfAlt:
-                stateMachine = &stateMachineHalf;
-                invert       = 0b01;
-                break;
-            default:
-                stateMachine = &stateMachineFull;
-                invert       = 0b00;
-        }
+        setMachine(profile_t::machineFor(mode), profile_t::invertFor(mode));
         return *this;
     }
 
@@ -202,27 +560,120 @@ namespace EncoderTool
     template <typename counter_t>
     EncoderBase<counter_t>& EncoderBase<counter_t>::setLimits(counter_t min, counter_t max, bool periodic)
     {
-        if (min < max)
-        {
-            this->minVal   = min;
-            this->maxVal   = max;
-            this->periodic = periodic;
-        } else
-        {
-            this->minVal   = std::numeric_limits<counter_t>::min();
-            this->maxVal   = std::numeric_limits<counter_t>::max();
-            this->periodic = true;
-        }
+        ownProfile().setLimits(min, max, periodic);
+        setValue(value); // move value into the new range
+        return *this;
+    }
+
+    template <typename counter_t>
+    EncoderBase<counter_t>& EncoderBase<counter_t>::setStepSize(counter_t stepSize)
+    {
+        ownProfile().setStepSize(stepSize);
         return *this;
     }
 
     template <typename counter_t>
     EncoderBase<counter_t>& EncoderBase<counter_t>::setAcceleration(AccelerationMode mode)
     {
-        this->accelMode = mode;
+        ownProfile().setAcceleration(mode);
+        return *this;
+    }
+
+    template <typename counter_t>
+    EncoderBase<counter_t>& EncoderBase<counter_t>::setOutputMode(OutputMode mode, uint8_t decayShift)
+    {
+        ownProfile().setOutputMode(mode, decayShift);
+        velocity = 0;
         return *this;
     }
 
+    template <typename counter_t>
+    EncoderBase<counter_t>& EncoderBase<counter_t>::setReversalHysteresis(uint8_t steps)
+    {
+        ownProfile().setReversalHysteresis(steps);
+        reversalPending = 0;
+        lastDirection   = 0;
+        return *this;
+    }
+
+    template <typename counter_t>
+    EncoderBase<counter_t>& EncoderBase<counter_t>::attachHistory(StepHistoryBase* _history)
+    {
+        if (_history != nullptr) _history->clear();
+        history = _history;
+        return *this;
+    }
+
+    template <typename counter_t>
+    EncoderBase<counter_t>& EncoderBase<counter_t>::attachAngleTracker(AngleTracker* tracker)
+    {
+        if (tracker != nullptr) tracker->reset();
+        angleTracker = tracker;
+        return *this;
+    }
+
+    template <typename counter_t>
+    EncoderBase<counter_t>& EncoderBase<counter_t>::setDetents(uint8_t countsPerDetent, uint8_t hysteresis)
+    {
+        ownProfile().setDetents(countsPerDetent, hysteresis);
+        detentOffset = 0;
+        detent       = 0;
+        return *this;
+    }
+
+    template <typename counter_t>
+    EncoderBase<counter_t>& EncoderBase<counter_t>::setProfile(const profile_t& _profile)
+    {
+        ATOMIC() // update() might run in an ISR
+        {
+            profile = &_profile;
+            if (_profile.stateMachine != nullptr) setMachine(_profile.stateMachine, _profile.invert);
+        }
+
+        velocity        = 0;
+        reversalPending = 0;
+        lastDirection   = 0;
+        detent          = 0;
+        setValue(value); // move value into the new range, resets detentOffset
+        return *this;
+    }
+
+    template <typename counter_t>
+    EncoderProfile_tpl<counter_t>& EncoderBase<counter_t>::ownProfile()
+    {
+        if (profile != &settings)
+        {
+            settings = *profile; // not in use by update(), no need to lock
+            ATOMIC()
+            {
+                profile = &settings;
+            }
+            settings.stateMachine = nullptr; // the count mode stays with the encoder
+        }
+        return settings;
+    }
+
+    template <typename counter_t>
+    void EncoderBase<counter_t>::setMachine(machine_t machine, uint8_t inv)
+    {
+        ATOMIC() // update() might run in an ISR
+        {
+            uint8_t input = (curState < 4 ? curState : curState - 3) ^ invert; // inputs which led to the current state
+            stateMachine  = machine;
+            invert        = inv;
+            curState      = input ^ invert; // resting state of the new mode, like begin()
+        }
+    }
+
+    template <typename counter_t>
+    EncoderBase<counter_t>::~EncoderBase()
+    {
+        if (composite == nullptr) return; // sources may go before their composite
+
+        if (composite->modifierButton == this) composite->modifierButton = nullptr;
+        composite->removeSource(*this);
+    }
+
     template <typename counter_t>
     void EncoderBase<counter_t>::begin(uint_fast8_t phaseA, uint_fast8_t phaseB)
     {
@@ -232,18 +683,18 @@ namespace EncoderTool
     template <typename counter_t>
     counter_t EncoderBase<counter_t>::getAcceleratedDelta(counter_t baseDelta)
     {
-        if (accelMode == AccelerationMode::NONE) {
+        if (profile->accelMode == AccelerationMode::NONE) {
             return baseDelta;
         }
 
-        unsigned long currentTime = millis();
+        unsigned long currentTime = TimeSource::now();
         unsigned long timeDelta = currentTime - lastUpdateTime;
         lastUpdateTime = currentTime;
 
         // Apply different acceleration curves based on mode
-        counter_t multiplier = 1;
+        int multiplier = 1;
         
-        switch (accelMode) {
+        switch (profile->accelMode) {
             case AccelerationMode::SLOW:
                 // Gentle acceleration: starts at 100ms
                 if (timeDelta < 20) {
@@ -288,97 +739,157 @@ namespace EncoderTool
     }
 
     template <typename counter_t>
-    counter_t EncoderBase<counter_t>::update(uint_fast8_t phaseA, uint_fast8_t phaseB, uint_fast8_t btn)
+    counter_t EncoderBase<counter_t>::step(counter_t delta)
+    {
+        const profile_t& p = *profile; // read once, the stores to the encoder state below could alias it
+        delta              = getAcceleratedDelta(delta);
+
+        counter_t v = value;
+        switch (p.limitMode)
+        {
+            case LimitMode::unbounded: // plain add, wraps around at the ends of the counter type
+                if (addOverflow(v, delta, &v)) carry = carry + (delta > 0 ? 1 : -1); // posted for Position64
+                break;
+
+            case LimitMode::clamped: // saturating add, reports the actual change
+            {
+                counter_t room; // distance to the limit, overflows only if it is larger than any delta
+                if (delta > 0 ? !subOverflow(p.maxVal, v, &room) && delta > room : !subOverflow(p.minVal, v, &room) && delta < room)
+                {
+                    if (room == 0) return 0; // at the limit, nothing changes
+                    delta = room;
+                }
+                v += delta;
+                break;
+            }
+
+            case LimitMode::periodicPow2: // offset to minVal modulo (span + stepSize)
+                v = wrappingAdd(p.minVal, maskBits(wrappingAdd(wrappingSub(v, p.minVal), delta), p.periodMask));
+                if (v > p.maxVal) v = delta > 0 ? p.minVal : p.maxVal; // off grid values: a partial step beyond the limit wraps
+                break;
+
+            default: // periodic, also handles deltas spanning several periods
+            {
+                counter_t d = delta, room; // distance to the end of the range, overflows only if it is larger than any delta
+                if (delta > 0)
+                {
+                    while (!subOverflow(p.maxVal, v, &room) && d > room)
+                    {
+                        d = d - room - p.stepSize; // wrapping from max to min is one step
+                        v = p.minVal;
+                        if (d < 0) d = 0; // off grid values: a partial step beyond max ends at min
+                    }
+                } else
+                {
+                    while (!subOverflow(p.minVal, v, &room) && d < room)
+                    {
+                        d = d - room + p.stepSize;
+                        v = p.maxVal;
+                        if (d > 0) d = 0;
+                    }
+                }
+                v += d;
+            }
+        }
+
+        value      = v;
+        valChanged = true;
+        if (p.detentSize == 1)
+            notify(delta);
+        else
+        {
+            counter_t crossed = crossDetents(delta);
+            if (crossed != 0) notify(crossed); // nothing to report between the virtual detents
+        }
+        return delta;
+    }
+
+    template <typename counter_t>
+    counter_t EncoderBase<counter_t>::reportSteps(int_fast8_t steps)
+    {
+        if (angleTracker != nullptr) angleTracker->add(steps);
+        if (profile->velocityDecay != 0) addVelocity(steps);
+        if (composite != nullptr) composite->sourceStep(compositeSlot, steps);
+        if (history != nullptr) history->add(steps);
+        return step(profile->stepSize * steps);
+    }
+
+    template <typename counter_t>
+    counter_t EncoderBase<counter_t>::reportCounts(int32_t counts)
+    {
+        counter_t delta = 0;
+        while (counts != 0)
+        {
+            int_fast8_t steps = counts > 64 ? 64 : counts < -64 ? -64 : (int_fast8_t)counts;
+            counts -= steps;
+            if (profile->reversalHysteresis != 0 && (steps == 1 || steps == -1)) steps = filterReversal(steps);
+            if (steps != 0) delta += reportSteps(steps);
+        }
+        return delta;
+    }
+
+    template <typename counter_t>
+    void EncoderBase<counter_t>::updateButton(uint_fast8_t btn)
     {
         if (button.update(btn))
         {
             btnChanged = true;
             if (btnCallback != nullptr) { btnCallback(button.read()); }
         }
+    }
 
+    template <typename counter_t>
+    counter_t EncoderBase<counter_t>::update(uint_fast8_t phaseA, uint_fast8_t phaseB, uint_fast8_t btn)
+    {
+        updateButton(btn);
+        return update(phaseA, phaseB);
+    }
+
+    template <typename counter_t>
+    counter_t EncoderBase<counter_t>::update(uint_fast8_t phaseA, uint_fast8_t phaseB)
+    {
         unsigned input = (phaseA << 1 | phaseB) ^ invert; // invert signals if necessary
-        if (stateMachine == nullptr) return 0;            // tick might get called from yield before class is initialized
+
+        counter_t oldPos = profile->outputMode == OutputMode::subStep ? subStepPosition(value, curState) : 0;
 
         curState          = (*stateMachine)[curState][input]; // get next state depending on new input
         uint8_t direction = curState & 0xF0;                  // direction is set if we need to count up / down or got an error
         curState &= 0x0F;                                     // remove the direction info from state
 
-        if (direction == UP)
+        counter_t delta = 0;
+        if (direction == UP || direction == DOWN)
         {
-            counter_t delta = getAcceleratedDelta(1);
-            
-            if (value + delta <= maxVal) // Check if we can add the full delta
-            {
-                value += delta;
-                valChanged = true;
-                if (callback != nullptr)
-                    callback(value, delta);
-                return delta;
-            }
-            else if (value < maxVal) // Partial increment to reach maxVal
-            {
-                counter_t actualDelta = maxVal - value;
-                value = maxVal;
-                valChanged = true;
-                if (callback != nullptr)
-                    callback(value, actualDelta);
-                return actualDelta;
-            }
-            else if (periodic) // if periodic, wrap to minVal
-            {
-                value = minVal;
-                valChanged = true;
-                if (callback != nullptr)
-                    callback(value, delta);
-                return delta;
-            }
-            value = maxVal;
-            return 0;
+            int_fast8_t steps = direction == UP ? 1 : -1;
+            if (profile->reversalHysteresis != 0) steps = filterReversal(steps); // 0 while a reversal is pending
+            if (steps != 0) delta = reportSteps(steps);
         }
-
-        if (direction == DOWN)
+        else if (direction == ERR)
         {
-            counter_t delta = getAcceleratedDelta(-1);
-            
-            if (value + delta >= minVal) // Check if we can subtract the full delta
-            {
-                value += delta; // delta is negative
-                valChanged = true;
-                if (callback != nullptr)
-                    callback(value, delta);
-                return delta;
-            }
-            else if (value > minVal) // Partial decrement to reach minVal
-            {
-                counter_t actualDelta = minVal - value; // negative
-                value = minVal;
-                valChanged = true;
-                if (callback != nullptr)
-                    callback(value, actualDelta);
-                return actualDelta;
-            }
-            else if (periodic) // if periodic, wrap to maxVal
-            {
-                value = maxVal;
-                valChanged = true;
-                if (callback != nullptr)
-                    callback(value, delta);
-                return delta;
-            }
-            value = minVal;
-            return 0;
-        }
-
+            if (errCount != 0xFF) errCount++;
 #if defined(USE_ERROR_CALLBACKS)
-        if (direction == ERR)
-        {
             if (errCallback != nullptr)
                 errCallback(value);
-        }
 #endif
-        return false;
+        }
+
+        if (profile->outputMode == OutputMode::subStep && callback != nullptr)
+        {
+            counter_t pos = subStepPosition(value, curState);
+            if (pos != oldPos) callback(pos, pos - oldPos);
+        }
+        return delta;
     }
 
+    template <typename counter_t>
+    const int8_t EncoderBase<counter_t>::subStepQtr[7]{
+        // A  B_cw  D_cw  C_cw  B_ccw  D_ccw  C_ccw
+        0, 1, 3, 2, -3, -1, -2};
+
+    template <typename counter_t>
+    const int8_t EncoderBase<counter_t>::subStepHalf[7]{ // detents at A and C
+        // A  B_cw  D_cw  C_cw  B_ccw  D_ccw  C_ccw
+        0, 2, 2, 0, -2, -2, 0};
+
     template <typename counter_t>
     const uint8_t EncoderBase<counter_t>::stateMachineQtr[7][4]{
         //             00         01          10         11
@@ -413,4 +924,8 @@ namespace EncoderTool
         /*2 D_cw*/ {A | UP, D_cw | ERR, D_cw, C_cw | DOWN},
         /*3 C_cw*/ {C_cw | ERR, B_cw | DOWN, D_cw | UP, C_cw},
     };
+
+    using EncoderProfile = EncoderProfile_tpl<int>;
 } // namespace EncoderTool
+
+#include "CompositeEncoder.h"
@@ -1,22 +1,40 @@
 #pragma once
 
-#include <Bounce2.h>
+#include "TimeSource.h"
 
 namespace EncoderTool
 {
-    class EncoderButton : public Bounce
+    /***********************************************************************
+     *  Button debouncer, the state changes after the input was stable for
+     *  'interval' ms. Reads the time only while the input differs from the
+     *  debounced state.
+     ************************************************************************/
+    class EncoderButton
     {
      public:
-        EncoderButton() : Bounce() {}
-
-        bool update(bool state)
+        bool update(bool input) // returns true if the debounced state changed
         {
-            curState = state;
-            return Bounce::update();
+            if (input == state && input == lastInput) return false; // nothing pending
+
+            unsigned long now = TimeSource::now();
+            if (input != lastInput)
+            {
+                lastInput = input;
+                since     = now;
+                return false;
+            }
+            if (now - since < interval) return false;
+
+            state = input;
+            return true;
         }
 
+        bool read() const { return state; }
+        void setInterval(uint16_t ms) { interval = ms; }
+
      protected:
-        bool readCurrentState() override { return curState; }
-        bool curState;
+        bool state = false, lastInput = false;
+        uint16_t interval   = 10;
+        unsigned long since = 0;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// Arduino independent decoder core (state machine, limits, acceleration, detents, events).
+// Compiles without Arduino, e.g. for host tools and tests. Front ends (pins, multiplexers,
+// port samplers) are included by EncoderTool.h, or implement the sample source concept (SampleSource.h).
+
+#include "CompositeEncoder.h"
+#include "EncoderBase.h"
+#include "Analog/SinCosEncoder.h"
+#include "Position64.h"
+#include "SampleSource.h"
@@ -10,6 +10,9 @@
 #include "Multiplexed/EncPlex4051.h"
 #include "Single/Encoder.h"
 #include "Single/PolledEncoder.h"
+#include "Multiplexed/PolledEncoderArray.h"
+#include "Position64.h"
+#include "Analog/SinCosEncoder.h"
 #include "Multiplexed/EncPlex4051.h"
 #include "Multiplexed/EncPlex4067.h"
 #include "Multiplexed/EncPlex74165.h"
\ No newline at end of file
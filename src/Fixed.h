@@ -0,0 +1,102 @@
+#pragma once
+
+#include "arithmetic.h"
+#include "config.h"
+#include <stdint.h>
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Minimal fixed point type which can be used as counter type, e.g.
+     *  PolledEncoder_tpl<Q16_16>. All arithmetic used by the encoders is
+     *  done on the underlying integer, i.e. no floating point math at run
+     *  time. Conversions from double are meant for constants like limits
+     *  or step sizes (evaluated at compile time if possible).
+     *
+     *  Q16_16 vol;                       // 16 integer bits, 16 fraction bits
+     *  encoder.setStepSize(0.05);        // 0.05 per step
+     *  encoder.setLimits(-60, 6);        // -60.0 ... 6.0
+     *  float dB = encoder.getValue().toFloat();
+     ************************************************************************/
+    template <typename raw_t, unsigned fracBits>
+    class Fixed
+    {
+     public:
+        Fixed() = default;
+        constexpr Fixed(int v) : raw((raw_t)v * one) {}
+        constexpr Fixed(long v) : raw((raw_t)v * one) {}
+        constexpr Fixed(double v) : raw((raw_t)(v * one + (v < 0 ? -0.5 : 0.5))) {}
+
+        static constexpr Fixed fromRaw(raw_t r) { return Fixed(r, 0); }
+        constexpr raw_t getRaw() const { return raw; }
+
+        constexpr int toInt() const { return (int)(raw >> fracBits); } // rounds towards -inf
+        constexpr float toFloat() const { return (float)raw / one; }
+        explicit constexpr operator float() const { return toFloat(); }
+
+        constexpr Fixed operator-() const { return fromRaw(-raw); }
+        Fixed& operator+=(Fixed b)
+        {
+            raw += b.raw;
+            return *this;
+        }
+        Fixed& operator-=(Fixed b)
+        {
+            raw -= b.raw;
+            return *this;
+        }
+
+        friend constexpr Fixed operator+(Fixed a, Fixed b) { return fromRaw(a.raw + b.raw); }
+        friend constexpr Fixed operator-(Fixed a, Fixed b) { return fromRaw(a.raw - b.raw); }
+        friend constexpr Fixed operator*(Fixed a, int b) { return fromRaw(a.raw * b); } // scaling by integers only
+        friend constexpr Fixed operator*(int a, Fixed b) { return fromRaw(a * b.raw); }
+
+        friend constexpr bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+        friend constexpr bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+        friend constexpr bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+        friend constexpr bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+        friend constexpr bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+        friend constexpr bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+
+        // overloads of the helpers in arithmetic.h, operating on the raw value
+        friend bool addOverflow(Fixed a, Fixed b, Fixed* r) { return EncoderTool::addOverflow(a.raw, b.raw, &r->raw); }
+        friend bool subOverflow(Fixed a, Fixed b, Fixed* r) { return EncoderTool::subOverflow(a.raw, b.raw, &r->raw); }
+        friend Fixed wrappingAdd(Fixed a, Fixed b) { return fromRaw(EncoderTool::wrappingAdd(a.raw, b.raw)); }
+        friend Fixed wrappingSub(Fixed a, Fixed b) { return fromRaw(EncoderTool::wrappingSub(a.raw, b.raw)); }
+        friend Fixed maskBits(Fixed a, Fixed mask) { return fromRaw(a.raw & mask.raw); }
+        friend constexpr Fixed lsb(Fixed) { return fromRaw(1); }
+        friend Fixed fromQ8(int32_t q8, Fixed) // keeps the fraction bits, saturates
+        {
+            constexpr unsigned up = fracBits >= 8 ? fracBits - 8 : 0, down = fracBits >= 8 ? 0 : 8 - fracBits;
+            int64_t r = (int64_t)q8 * ((int64_t)1 << up) / (1 << down);
+            if (r > std::numeric_limits<raw_t>::max()) return fromRaw(std::numeric_limits<raw_t>::max());
+            if (r < std::numeric_limits<raw_t>::min()) return fromRaw(std::numeric_limits<raw_t>::min());
+            return fromRaw((raw_t)r);
+        }
+
+     protected:
+        static constexpr raw_t one = (raw_t)1 << fracBits;
+        constexpr Fixed(raw_t r, int) : raw(r) {}
+
+        raw_t raw;
+    };
+
+    using Q16_16 = Fixed<int32_t, 16>;
+    using Q24_8  = Fixed<int32_t, 8>;
+    using Q8_8   = Fixed<int16_t, 8>;
+}
+
+namespace std
+{
+    template <typename raw_t, unsigned fracBits>
+    struct numeric_limits<EncoderTool::Fixed<raw_t, fracBits>> : public numeric_limits<raw_t>
+    {
+        using fixed_t = EncoderTool::Fixed<raw_t, fracBits>;
+
+        static constexpr bool is_integer = false;
+        static constexpr fixed_t min() { return fixed_t::fromRaw(numeric_limits<raw_t>::min()); }
+        static constexpr fixed_t max() { return fixed_t::fromRaw(numeric_limits<raw_t>::max()); }
+        static constexpr fixed_t lowest() { return min(); }
+        static constexpr fixed_t epsilon() { return fixed_t::fromRaw(1); }
+    };
+}
@@ -5,7 +5,10 @@
 #ifndef SIMPLY_ATOMIC_h
 #define SIMPLY_ATOMIC_h
 
-#if defined(__AVR__)
+#if !defined(ARDUINO) // host builds of the decoder core (EncoderCore.h), no interrupts to protect against
+    #define ATOMIC() for (int _sa_done = 1; _sa_done; _sa_done = 0)
+
+#elif defined(__AVR__)
     #include "avr.h"
 
 #elif defined(__arm__)
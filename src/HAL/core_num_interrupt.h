@@ -1,6 +1,10 @@
 #pragma once
 
-#include "Arduino.h"
+#if defined(ARDUINO)
+    #include "Arduino.h"
+#else
+    #include "host.h" // simulated pins and timers for host builds
+#endif
 
 #if !defined(CORE_NUM_INTERRUPT)
 
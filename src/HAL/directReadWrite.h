@@ -1,6 +1,10 @@
 #pragma once
 
-#include "Arduino.h"
+#if defined(ARDUINO)
+    #include "Arduino.h"
+#else
+    #include "host.h" // simulated pins and timers for host builds
+#endif
 #include "SimplyAtomic/SimplyAtomic.h"
 #include "cores.h"
 
@@ -53,6 +57,11 @@ namespace HAL
         }
     }
 
+    #define HAL_HAS_PORT_ACCESS
+    using port_t = uint8_t;
+    inline const volatile port_t* portRegister(const pinRegInfo_t& info) { return info.in; }
+    inline port_t portMask(const pinRegInfo_t& info) { return info.mask; }
+
 #elif defined(CORE_TEENSY__TEENSY3) //--------------------------
     struct pinRegInfo_t
     {
@@ -70,6 +79,7 @@ namespace HAL
 
     pinRegInfo_t::pinRegInfo_t(uint8_t _pin)
     {
+        if (_pin >= NUM_DIGITAL_PINS) return;
         pin  = _pin;
         in   = portInputRegister(pin);
         clr  = portClearRegister(pin);
@@ -102,6 +112,40 @@ namespace HAL
         #endif
     }
 
+    #define HAL_HAS_PORT_ACCESS
+    using port_t = uint32_t;
+    #if defined(KINETISK) // Teensy 3.x: 'in' is the bit band alias of the pin's bit in GPIOx_PDIR
+    inline const volatile port_t* portRegister(const pinRegInfo_t& info)
+    {
+        if (info.in == nullptr) return nullptr;
+        return (const volatile port_t*)(0x40000000 + ((((uintptr_t)info.in - 0x42000000) >> 5) & ~(uintptr_t)3));
+    }
+    inline port_t portMask(const pinRegInfo_t& info)
+    {
+        if (info.in == nullptr) return 0;
+        return (port_t)1 << ((((uintptr_t)info.in - 0x42000000) >> 2) & 31);
+    }
+    #else // Teensy LC: 'in' is the byte of FGPIOx_PDIR holding the pin
+    inline const volatile port_t* portRegister(const pinRegInfo_t& info)
+    {
+        return (const volatile port_t*)((uintptr_t)info.in & ~(uintptr_t)3);
+    }
+    inline port_t portMask(const pinRegInfo_t& info)
+    {
+        if (info.in == nullptr) return 0;
+        return info.mask << (8 * ((uintptr_t)info.in & 3));
+    }
+
+    // The single cycle FGPIO port is only accessible by the core, DMA reads the same register through GPIO
+    #define HAL_HAS_DMA_PORT
+    inline const volatile port_t* dmaPortRegister(const pinRegInfo_t& info)
+    {
+        if (info.in == nullptr) return nullptr;
+        return (const volatile port_t*)((uintptr_t)portRegister(info) - 0xF80FF000 + 0x400FF000); // FGPIOx_PDIR -> GPIOx_PDIR
+    }
+    inline void routeToDmaPort(const pinRegInfo_t&) {}
+    #endif
+
 #elif defined(CORE_TEENSY__TEENSY4) //--------------------------------------------
 
     struct pinRegInfo_t
@@ -145,6 +189,28 @@ namespace HAL
         return (*info.in & info.mask) ? 1 : 0;
     }
 
+    #define HAL_HAS_PORT_ACCESS
+    using port_t = uint32_t;
+    inline const volatile port_t* portRegister(const pinRegInfo_t& info) { return info.in; } // fast GPIO6..9
+    inline port_t portMask(const pinRegInfo_t& info) { return info.mask; }
+
+    // DMA can't read the fast GPIO6..9 (tightly coupled to the core). The same pins (same bit positions) are
+    // available on the normal GPIO1..4 once IOMUXC_GPR_GPR26..29 route them there. Fast digitalRead/Write
+    // of a routed pin doesn't work anymore.
+    #define HAL_HAS_DMA_PORT
+    inline const volatile port_t* dmaPortRegister(const pinRegInfo_t& info)
+    {
+        if (info.in == nullptr) return nullptr;
+        uintptr_t fast = (uintptr_t)info.in - 0x42000000;   // GPIO6_DR, GPIO7..9 follow in steps of 0x4000
+        return (const volatile port_t*)(0x401B8000 + fast); // GPIO1_DR, GPIO2..4 follow in steps of 0x4000
+    }
+    inline void routeToDmaPort(const pinRegInfo_t& info)
+    {
+        if (info.in == nullptr) return;
+        unsigned gpio = ((uintptr_t)info.in - 0x42000000) >> 14; // 0..3 for GPIO6..9
+        (&IOMUXC_GPR_GPR26)[gpio] &= ~info.mask;                 // GPR26..29 select fast (1) or normal (0) GPIO per pin
+    }
+
 #elif defined(CORE_SAMD_SEED__ARDUINO) || defined(ARDUINO_SAMD__ARDUINO) //------------------------------------------------
 
     struct pinRegInfo_t
@@ -185,6 +251,47 @@ namespace HAL
         return (*info.in & info.mask) ? 1 : 0;
     }
 
+    #define HAL_HAS_PORT_ACCESS
+    using port_t = uint32_t;
+    inline const volatile port_t* portRegister(const pinRegInfo_t& info) { return info.in; }
+    inline port_t portMask(const pinRegInfo_t& info) { return info.mask; }
+
+#elif !defined(ARDUINO) // host builds, simulated port of host.h ------------------------------------
+
+    struct pinRegInfo_t
+    {
+        uint8_t pin = -1;
+        const volatile uint32_t* in = nullptr;
+        uint32_t mask = 0;
+
+        pinRegInfo_t() = default;
+        inline pinRegInfo_t(uint8_t _pin)
+        {
+            if (_pin >= NUM_DIGITAL_PINS) return;
+            pin  = _pin;
+            in   = &HostBoard::port();
+            mask = UINT32_C(1) << pin;
+        }
+    };
+
+    inline pinRegInfo_t getPinRegInfo(uint8_t pin)
+    {
+        return pinRegInfo_t(pin);
+    }
+    inline void directWrite(const pinRegInfo_t& info, uint8_t value)
+    {
+        HostBoard::setPin(info.pin, value);
+    }
+    inline uint8_t directRead(const pinRegInfo_t& info)
+    {
+        return (*info.in & info.mask) ? 1 : 0;
+    }
+
+    #define HAL_HAS_PORT_ACCESS
+    using port_t = uint32_t;
+    inline const volatile port_t* portRegister(const pinRegInfo_t& info) { return info.in; }
+    inline port_t portMask(const pinRegInfo_t& info) { return info.mask; }
+
 #else // Fallback ----------------------------------------------------------------------------------
 
     struct pinRegInfo_t
@@ -206,6 +313,43 @@ namespace HAL
     {
         return digitalRead(pin.pin);
     }
+
+    // no port registers, pins 0..31 are mapped to the bits of a virtual port (software producers)
+    #define HAL_HAS_PORT_ACCESS
+    using port_t = uint32_t;
+    inline const volatile port_t* portRegister(const pinRegInfo_t&) { return nullptr; }
+    inline port_t portMask(const pinRegInfo_t& info) { return info.pin < 32 ? (port_t)1 << info.pin : 0; }
+#endif
+
+
+#if defined(HAL_HAS_PORT_ACCESS) && !defined(HAL_HAS_DMA_PORT) // DMA reads the same register as the core
+    inline const volatile port_t* dmaPortRegister(const pinRegInfo_t& info) { return portRegister(info); }
+    inline void routeToDmaPort(const pinRegInfo_t&) {}
 #endif
 
+    // Pin known at compile time. On Teensies digitalReadFast() compiles to a read from a constant address,
+    // the other cores use the register info which is stored once per pin (static).
+    template <uint8_t pin>
+    struct FixedPin
+    {
+        static void begin(int mode)
+        {
+            pinMode(pin, mode);
+            info = pinRegInfo_t(pin);
+        }
+
+        static uint8_t read()
+        {
+#if defined(CORE_TEENSY__TEENSY4) || defined(CORE_TEENSY__TEENSY3)
+            return digitalReadFast(pin);
+#else
+            return directRead(info);
+#endif
+        }
+
+        static pinRegInfo_t info;
+    };
+
+    template <uint8_t pin>
+    pinRegInfo_t FixedPin<pin>::info;
 }
\ No newline at end of file
@@ -0,0 +1,144 @@
+#pragma once
+
+// Minimal Arduino API for builds without Arduino (host tests, simulations). Included by the HAL instead of Arduino.h
+//
+// Pins 0..31 form one simulated port. The test drives them with HAL::HostBoard::setPin(), a level change invokes
+// the attached pin interrupt (CHANGE only). micros() is a virtual clock, HostBoard::advance() moves it forward and
+// fires the IntervalTimers which became due in between.
+
+#include <stdint.h>
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define NUM_DIGITAL_PINS 32
+#define NOT_AN_INTERRUPT 0xFF
+#define CORE_NUM_INTERRUPT 32
+
+namespace HAL
+{
+    struct HostBoard
+    {
+        using isr_t = void (*)();
+
+        static void setPin(uint8_t pin, uint8_t level) // input level, invokes the pin interrupt on a change
+        {
+            if (pin >= NUM_DIGITAL_PINS) return;
+            uint32_t mask = UINT32_C(1) << pin;
+            uint32_t old  = port();
+            port()        = level ? old | mask : old & ~mask;
+            if (port() != old && isr(pin) != nullptr)
+            {
+                pinInterrupts()++;
+                isr(pin)();
+            }
+        }
+        static void advance(unsigned long us); // moves the clock, fires the due timers in order
+
+        static volatile uint32_t& port() // input register of the simulated port
+        {
+            static volatile uint32_t p = 0;
+            return p;
+        }
+        static isr_t& isr(uint8_t slot)
+        {
+            static isr_t isrs[CORE_NUM_INTERRUPT] = {};
+            return isrs[slot];
+        }
+        static unsigned long& micros()
+        {
+            static unsigned long t = 0;
+            return t;
+        }
+        static unsigned long& pinInterrupts() // number of invoked pin interrupts
+        {
+            static unsigned long n = 0;
+            return n;
+        }
+    };
+}
+
+inline void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (mode == INPUT_PULLUP && pin < NUM_DIGITAL_PINS) HAL::HostBoard::port() |= UINT32_C(1) << pin; // open input reads HIGH
+}
+inline int digitalRead(uint8_t pin) { return pin < NUM_DIGITAL_PINS && (HAL::HostBoard::port() >> pin) & 1; }
+inline void digitalWrite(uint8_t pin, uint8_t level) { HAL::HostBoard::setPin(pin, level); }
+
+inline uint8_t digitalPinToInterrupt(uint8_t pin) { return pin < CORE_NUM_INTERRUPT ? pin : NOT_AN_INTERRUPT; }
+inline void attachInterrupt(uint8_t slot, void (*isr)(), int) { HAL::HostBoard::isr(slot) = isr; }
+inline void detachInterrupt(uint8_t slot) { HAL::HostBoard::isr(slot) = nullptr; }
+
+inline unsigned long micros() { return HAL::HostBoard::micros(); }
+inline unsigned long millis() { return HAL::HostBoard::micros() / 1000; }
+inline void delayMicroseconds(unsigned us) { HAL::HostBoard::advance(us); }
+
+// Periodic timer with the interface of the Teensy IntervalTimer, runs on the virtual clock
+class IntervalTimer
+{
+ public:
+    ~IntervalTimer() { end(); }
+
+    bool begin(void (*f)(), unsigned microseconds)
+    {
+        if (f == nullptr || microseconds == 0) return false;
+        if (!running)
+        {
+            unsigned i = 0;
+            while (i < maxTimers && list()[i] != nullptr) i++;
+            if (i == maxTimers) return false; // all channels in use
+            list()[i] = this;
+        }
+        running = true;
+        period  = microseconds;
+        due     = HAL::HostBoard::micros() + microseconds;
+        funct   = f;
+        return true;
+    }
+
+    void end()
+    {
+        if (!running) return;
+        running = false;
+        for (unsigned i = 0; i < maxTimers; i++)
+            if (list()[i] == this) list()[i] = nullptr;
+    }
+
+    static constexpr unsigned maxTimers = 4; // like the PIT channels of a Teensy
+
+ protected:
+    static IntervalTimer** list()
+    {
+        static IntervalTimer* timers[maxTimers] = {};
+        return timers;
+    }
+
+    bool running = false;
+    unsigned long period = 0, due = 0;
+    void (*funct)() = nullptr;
+
+    friend struct HAL::HostBoard;
+};
+
+inline void HAL::HostBoard::advance(unsigned long us)
+{
+    unsigned long end = micros() + us;
+    for (;;)
+    {
+        IntervalTimer* next = nullptr; // earliest due timer
+        for (unsigned i = 0; i < IntervalTimer::maxTimers; i++)
+        {
+            IntervalTimer* t = IntervalTimer::list()[i];
+            if (t != nullptr && (long)(end - t->due) >= 0 && (next == nullptr || (long)(next->due - t->due) > 0)) next = t;
+        }
+        if (next == nullptr) break;
+
+        micros() = next->due;
+        next->due += next->period;
+        next->funct(); // might end() or restart the timer
+    }
+    micros() = end;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#if defined(ARDUINO)
+    #include "Arduino.h"
+#else
+    #include "host.h"
+#endif
+#include "cores.h"
+
+#if defined(CORE_TEENSY__TEENSY4) || defined(CORE_TEENSY__TEENSY3) || !defined(ARDUINO)
+    #if defined(ARDUINO)
+        #include "IntervalTimer.h"
+    #endif
+    #define HAL_HAS_ONESHOT_TIMER
+
+namespace HAL
+{
+    // Invokes object->MEMBER() once, 'microseconds' after start(). Each object reserves one of 'slots' relays,
+    // the hardware timer (IntervalTimer) is only allocated while the timer runs.
+    template <typename TYPE, void (TYPE::*MEMBER)()>
+    class OneShotTimer
+    {
+     public:
+        static bool reserve(TYPE* object);                      // false if all relays are in use
+        static void release(TYPE* object);                      // stops the timer and frees the relay
+        static bool start(TYPE* object, unsigned microseconds); // false if not reserved or no hardware timer is free
+
+        static constexpr uint8_t slots = 4; // PIT channels of the Teensies
+
+     protected:
+        template <uint8_t nr>
+        static void relay()
+        {
+            timers[nr].end(); // one shot
+            (objects[nr]->*MEMBER)();
+        }
+
+        static uint8_t find(const TYPE* object);
+
+        static TYPE* objects[slots];
+        static IntervalTimer timers[slots];
+    };
+
+    // inline implementation ===========================================================================
+
+    template <typename TYPE, void (TYPE::*MEMBER)()>
+    uint8_t OneShotTimer<TYPE, MEMBER>::find(const TYPE* object)
+    {
+        for (uint8_t i = 0; i < slots; i++)
+            if (objects[i] == object) return i;
+        return slots;
+    }
+
+    template <typename TYPE, void (TYPE::*MEMBER)()>
+    bool OneShotTimer<TYPE, MEMBER>::reserve(TYPE* object)
+    {
+        if (find(object) < slots) return true;
+        uint8_t nr = find(nullptr);
+        if (nr == slots) return false;
+        objects[nr] = object;
+        return true;
+    }
+
+    template <typename TYPE, void (TYPE::*MEMBER)()>
+    void OneShotTimer<TYPE, MEMBER>::release(TYPE* object)
+    {
+        uint8_t nr = find(object);
+        if (nr == slots) return;
+        timers[nr].end();
+        objects[nr] = nullptr;
+    }
+
+    template <typename TYPE, void (TYPE::*MEMBER)()>
+    bool OneShotTimer<TYPE, MEMBER>::start(TYPE* object, unsigned microseconds)
+    {
+        switch (find(object))
+        {
+            case 0: return timers[0].begin(relay<0>, microseconds);
+            case 1: return timers[1].begin(relay<1>, microseconds);
+            case 2: return timers[2].begin(relay<2>, microseconds);
+            case 3: return timers[3].begin(relay<3>, microseconds);
+            default: return false;
+        }
+    }
+
+    //--------------------------------------------------------------------------------------------------
+    template <typename TYPE, void (TYPE::*MEMBER)()>
+    TYPE* OneShotTimer<TYPE, MEMBER>::objects[];
+
+    template <typename TYPE, void (TYPE::*MEMBER)()>
+    IntervalTimer OneShotTimer<TYPE, MEMBER>::timers[];
+}
+#endif
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "TimeSource.h"
+#include "config.h"
+
+namespace EncoderTool
+{
+    class IdleGroup;
+
+    /***********************************************************************
+     *  Inactivity detection for polled encoders and multiplexers
+     *
+     *  If no encoder moved and no button changed for 'timeout' ms the
+     *  source is considered idle. While idle, tick() only scans the inputs
+     *  every 'wakeInterval' ms (wake check). Any change switches back to
+     *  full rate scanning. Idle/active transitions are reported by the
+     *  idle callback.
+     ************************************************************************/
+    class IdleMonitor
+    {
+     public:
+#if defined(USE_MODERN_CALLBACKS)
+        using idleCallback_t = stdext::inplace_function<void(bool idle)>;
+#else
+        using idleCallback_t = void (*)(bool idle);
+#endif
+
+        void setIdleTimeout(unsigned timeout, unsigned wakeInterval = 50); // timeout = 0 disables idle detection
+        void attachIdleCallback(idleCallback_t cb) { idleCallback = cb; }
+        bool isIdle() const { return idle; }
+
+     protected:
+        inline bool idleScanDue(); // true if the inputs need to be scanned in this tick
+        inline void checkIdle();   // call after scanning
+        void activity() { active = true; }
+
+        unsigned timeout = 0, wakeInterval = 0;
+        unsigned long now = 0, lastActivity = 0, lastScan = 0;
+        bool idle = false, active = false;
+
+        idleCallback_t idleCallback = nullptr;
+        IdleGroup* group            = nullptr;
+
+        friend class IdleGroup;
+    };
+
+    /***********************************************************************
+     *  Combines several IdleMonitors (multiplexers, polled encoders).
+     *  The group is idle if all members are idle. The callback is invoked
+     *  when the last member gets idle and when the first member gets active
+     *  again, i.e. the place to enter / leave low power modes.
+     ************************************************************************/
+    class IdleGroup
+    {
+     public:
+        using idleCallback_t = IdleMonitor::idleCallback_t;
+
+        void add(IdleMonitor& member)
+        {
+            member.group = this;
+            memberCount++;
+            if (member.idle) idleCount++;
+        }
+        void attachIdleCallback(idleCallback_t cb) { idleCallback = cb; }
+        bool isIdle() const { return memberCount > 0 && idleCount == memberCount; }
+
+     protected:
+        void memberChanged(bool memberIdle)
+        {
+            if (memberIdle)
+            {
+                if (++idleCount == memberCount && idleCallback != nullptr) idleCallback(true);
+            } else
+            {
+                if (idleCount-- == memberCount && idleCallback != nullptr) idleCallback(false);
+            }
+        }
+
+        unsigned memberCount = 0, idleCount = 0;
+        idleCallback_t idleCallback = nullptr;
+
+        friend class IdleMonitor;
+    };
+
+    // INLINE IMPLEMENTATION ==========================================================================
+
+    inline void IdleMonitor::setIdleTimeout(unsigned _timeout, unsigned _wakeInterval)
+    {
+        timeout      = _timeout;
+        wakeInterval = _wakeInterval;
+        lastActivity = TimeSource::now();
+    }
+
+    bool IdleMonitor::idleScanDue()
+    {
+        if (timeout == 0) return true; // idle detection disabled, no need to read the time
+
+        now = TimeSource::now();
+        if (!idle) return true;
+        if (now - lastScan < wakeInterval) return false;
+        lastScan = now;
+        return true;
+    }
+
+    void IdleMonitor::checkIdle()
+    {
+        if (timeout == 0) return;
+
+        if (active)
+        {
+            active       = false;
+            lastActivity = now;
+            if (idle)
+            {
+                idle = false;
+                if (idleCallback != nullptr) idleCallback(false);
+                if (group != nullptr) group->memberChanged(false);
+            }
+        } else if (!idle && now - lastActivity >= timeout)
+        {
+            idle     = true;
+            lastScan = now;
+            if (idleCallback != nullptr) idleCallback(true);
+            if (group != nullptr) group->memberChanged(true);
+        }
+    }
+}
@@ -31,6 +31,9 @@ namespace EncoderTool
     template <typename counter_t>
     void EncPlex4067_tpl<counter_t>::begin(CountMode mode)
     {
+        using HAL::directRead;
+        using HAL::directWrite;
+
         EncPlexBase<counter_t>::begin(mode);
         pinMode(S0.pin, OUTPUT);
         pinMode(S1.pin, OUTPUT);
@@ -39,6 +42,17 @@ namespace EncoderTool
 
         pinMode(A.pin, INPUT);
         pinMode(B.pin, INPUT);
+
+        for (unsigned i = 0; i < EncPlexBase<counter_t>::encoderCount; i++) // capture start state of all encoders
+        {
+            directWrite(S0, i & 0b0001);
+            directWrite(S1, i & 0b0010);
+            directWrite(S2, i & 0b0100);
+            directWrite(S3, i & 0b1000);
+            delayMicroseconds(1);
+
+            EncPlexBase<counter_t>::encoders[i].begin(directRead(A), directRead(B));
+        }
     }
 
     template <typename counter_t>
@@ -47,6 +61,9 @@ namespace EncoderTool
         using HAL::directRead;
         using HAL::directWrite;
 
+        this->decayVelocities(); // keeps decaying while idle
+        if (!this->idleScanDue()) return;
+
         for (unsigned i = 0; i < EncPlexBase<counter_t>::encoderCount; i++)
         {
             directWrite(S0, i & 0b0001);
@@ -55,12 +72,10 @@ namespace EncoderTool
             directWrite(S3, i & 0b1000);
             delayMicroseconds(1);
 
-            int delta = EncPlexBase<counter_t>::encoders[i].update(directRead(A), directRead(B));
-            if (delta != 0 && EncPlexBase<counter_t>::callback != nullptr)
-            {
-                EncPlexBase<counter_t>::callback(i, EncPlexBase<counter_t>::encoders[i].getValue(), delta);
-            }
+            EncPlexBase<counter_t>::process(i, directRead(A), directRead(B));
         }
+        this->checkIdle();
+        this->checkFaults();
     }
 
     using EncPlex4067 = EncPlex4067_tpl<int>;
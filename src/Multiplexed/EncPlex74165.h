@@ -3,7 +3,6 @@
 #include "../HAL/directReadWrite.h"
 #include "../delay.h"
 #include "Arduino.h"
-#include "Bounce2.h"
 #include "EncPlexBase.h"
 
 namespace EncoderTool
@@ -81,6 +80,9 @@ namespace EncoderTool
         using HAL::directRead;
         using HAL::directWrite;
 
+        this->decayVelocities();          // keeps decaying while idle
+        if (!this->idleScanDue()) return; // while idle only one load per wake interval
+
         // load current values to shift register
         directWrite(LD, LOW);
         delay50ns();
@@ -88,29 +90,27 @@ namespace EncoderTool
         delay50ns();
         directWrite(LD, HIGH);
 
-        // first values are available directly after loading
-        int a = directRead(A);
-        int b = directRead(B);
-        int btn = Btn.pin < NUM_DIGITAL_PINS ? directRead(Btn) : LOW;
+        bool scanButtons = Btn.pin < NUM_DIGITAL_PINS && this->buttonScanDue(); // no button reads at all on the other ticks
 
-        int delta = EncPlexBase<counter_t>::encoders[0].update(a, b, btn);
+        // first values are available directly after loading
+        if (scanButtons)
+            EncPlexBase<counter_t>::process(0, directRead(A), directRead(B), directRead(Btn));
+        else
+            EncPlexBase<counter_t>::process(0, directRead(A), directRead(B));
 
-        if (delta != 0 && EncPlexBase<counter_t>::callback != nullptr)
-        {
-            EncPlexBase<counter_t>::callback(0, EncPlexBase<counter_t>::encoders[0].getValue(), delta);
-        }
         for (unsigned i = 1; i < EncPlexBase<counter_t>::encoderCount; i++) // shift in the the rest of the encoders
         {
             directWrite(CLK, HIGH);
             delay50ns();
-            int delta = EncPlexBase<counter_t>::encoders[i].update(directRead(A), directRead(B), Btn.pin < NUM_DIGITAL_PINS ? directRead(Btn) : LOW);
-            if (delta != 0 && EncPlexBase<counter_t>::callback != nullptr)
-            {
-                EncPlexBase<counter_t>::callback(i, EncPlexBase<counter_t>::encoders[i].getValue(), delta);
-            }
+            if (scanButtons)
+                EncPlexBase<counter_t>::process(i, directRead(A), directRead(B), directRead(Btn));
+            else
+                EncPlexBase<counter_t>::process(i, directRead(A), directRead(B));
             directWrite(CLK, LOW);
             delay50ns();
         }
+        this->checkIdle();
+        this->checkFaults();
     }
 
     using EncPlex74165 = EncPlex74165_tpl<int>;
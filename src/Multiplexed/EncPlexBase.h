@@ -1,24 +1,42 @@
 #pragma once
 
 #include "EncoderBase.h"
+#include "IdleMonitor.h"
 #include "config.h"
 
 namespace EncoderTool
 {
     template <typename counter_t>
-    class EncPlexBase
+    class EncPlexBase : public IdleMonitor
     {
      public:
 #if defined(PLAIN_ENC_CALLBACK)
         using allCallback_t    = stdext::inplace_function<void(uint_fast8_t channel, counter_t value, counter_t delta)>; // all encoder values
         using allBtnCallback_t = stdext::inplace_function<void(uint_fast8_t channel, int_fast8_t state)>;                // all encoder buttons
+        using faultCallback_t  = stdext::inplace_function<void(uint_fast8_t channel, bool faulted)>;                     // channel quarantined / recovered
 #else
         using allCallback_t    = void (*)(uint_fast8_t channel, counter_t value, counter_t delta);
         using allBtnCallback_t = void (*)(uint_fast8_t channel, int_fast8_t state);
+        using faultCallback_t  = void (*)(uint_fast8_t channel, bool faulted);
 #endif
 
         void attachCallback(allCallback_t callback);
         EncoderBase<counter_t>& operator[](size_t idx);
+        size_t getEncoderCount() const { return encoderCount; }
+
+        // Shared configuration for the channels first ... first + count - 1, see EncoderProfile_tpl in EncoderBase.h
+        inline void applyProfile(unsigned first, unsigned count, const EncoderProfile_tpl<counter_t>& profile);
+
+        // Line fault detection: a channel is quarantined (not decoded, no callbacks) if it shows more than 'maxErrors'
+        // invalid transitions within 'window' ms or if it stays between two detents for more than 'stuckTimeout' ms.
+        // It recovers once its inputs rest at a detent for 'stuckTimeout' ms or after 'recoverTransitions' valid
+        // transitions in a row. maxErrors = 0 disables the detection.
+        // The stuck detection can't fire in CountMode::full, every state is a detent there.
+        inline void setFaultDetection(uint8_t maxErrors, unsigned window = 100, unsigned stuckTimeout = 1000);
+        void attachFaultCallback(faultCallback_t cb) { faultCallback = cb; }
+        bool isFaulted(size_t idx) const { return health != nullptr && idx < encoderCount && health[idx].faulted; }
+
+        void setButtonDecimation(uint8_t n) { btnDecimation = n > 0 ? n : 1; } // read the buttons only every n-th tick
 
      protected:
         EncPlexBase(unsigned EncoderCount);
@@ -27,11 +45,36 @@ namespace EncoderTool
         void begin(CountMode mode = CountMode::quarter);
         void begin(allCallback_t, CountMode mode = CountMode::quarter);
 
+        inline void process(unsigned ch, uint_fast8_t phaseA, uint_fast8_t phaseB, uint_fast8_t btn); // decode channel ch and dispatch callbacks
+        inline void process(unsigned ch, uint_fast8_t phaseA, uint_fast8_t phaseB);                   // same, without button
+        inline void checkFaults();                                                                    // call after scanning
+        inline bool buttonScanDue();                                                                  // call once per tick
+        inline void decayVelocities();                                                                // call once per tick
+
+        uint8_t btnDecimation = 1, btnCountdown = 0;
+
+        static constexpr uint8_t recoverTransitions = 8; // two signal periods of valid gray code
+
         const size_t encoderCount;
         EncoderBase<counter_t>* encoders;
 
         allCallback_t callback = nullptr;
         counter_t c;
+        bool anyVelocity = false; // a channel with velocity output moved, decayVelocities() has work to do
+
+        struct health_t
+        {
+            unsigned long since; // last time at a detent (healthy) or last input change (faulted)
+            uint8_t input;       // last input of a quarantined channel (A << 1 | B)
+            uint8_t valid;       // valid transitions in a row while quarantined
+            bool changed;
+            bool faulted;
+        };
+        health_t* health              = nullptr; // allocated by setFaultDetection()
+        faultCallback_t faultCallback = nullptr;
+        uint8_t maxErrors             = 0;
+        unsigned faultWindow = 0, stuckTimeout = 0;
+        unsigned long windowStart = 0, lastFaultCheck = 0;
     };
 
     template <typename counter_t>
@@ -46,14 +89,45 @@ namespace EncoderTool
     {
         for (unsigned i = 0; i < encoderCount; i++)
         {
+            if (encoders[i].profile->stateMachine != nullptr) continue; // count mode set by the applied profile
             encoders[i].setCountMode(mode);
         }
     }
 
+    template <typename counter_t>
+    void EncPlexBase<counter_t>::applyProfile(unsigned first, unsigned count, const EncoderProfile_tpl<counter_t>& profile)
+    {
+        for (unsigned i = first; i < encoderCount && i - first < count; i++)
+        {
+            encoders[i].setProfile(profile);
+        }
+    }
+
     template <typename counter_t>
     EncPlexBase<counter_t>::~EncPlexBase()
     {
         delete[] encoders;
+        delete[] health;
+    }
+
+    template <typename counter_t>
+    void EncPlexBase<counter_t>::setFaultDetection(uint8_t _maxErrors, unsigned window, unsigned _stuckTimeout)
+    {
+        maxErrors    = _maxErrors;
+        faultWindow  = window;
+        stuckTimeout = _stuckTimeout;
+
+        delete[] health;
+        health = nullptr;
+        if (maxErrors == 0) return;
+
+        health      = new health_t[encoderCount]();
+        windowStart = TimeSource::now();
+        for (unsigned i = 0; i < encoderCount; i++)
+        {
+            health[i].since      = windowStart;
+            encoders[i].errCount = 0;
+        }
     }
 
     template <typename counter_t>
@@ -62,6 +136,142 @@ namespace EncoderTool
         return idx < encoderCount ? encoders[idx] : encoders[encoderCount - 1];
     }
 
+    template <typename counter_t>
+    bool EncPlexBase<counter_t>::buttonScanDue()
+    {
+        if (btnCountdown != 0)
+        {
+            btnCountdown--;
+            return false;
+        }
+        btnCountdown = btnDecimation - 1;
+        return true;
+    }
+
+    template <typename counter_t>
+    void EncPlexBase<counter_t>::process(unsigned ch, uint_fast8_t phaseA, uint_fast8_t phaseB, uint_fast8_t btn)
+    {
+        EncoderBase<counter_t>& encoder = encoders[ch];
+
+        bool btnState = encoder.button.read();
+        encoder.updateButton(btn);
+        if (encoder.button.read() != btnState) activity();
+
+        process(ch, phaseA, phaseB);
+    }
+
+    template <typename counter_t>
+    void EncPlexBase<counter_t>::process(unsigned ch, uint_fast8_t phaseA, uint_fast8_t phaseB)
+    {
+        EncoderBase<counter_t>& encoder = encoders[ch];
+
+        if (health != nullptr && health[ch].faulted) // quarantined, only watch the inputs for recovery
+        {
+            health_t& h   = health[ch];
+            uint8_t input = phaseA << 1 | phaseB;
+            if (input != h.input)
+            {
+                uint8_t diff = input ^ h.input; // gray code: one line changes at a time
+                h.valid      = diff == 0b01 || diff == 0b10 ? (h.valid < recoverTransitions ? h.valid + 1 : h.valid) : 0;
+                h.input      = input;
+                h.changed    = true;
+            }
+            return;
+        }
+
+        uint8_t state    = encoder.curState;
+        counter_t detent = encoder.detent;
+        counter_t delta  = encoder.update(phaseA, phaseB);
+        if (delta != 0 && callback != nullptr)
+        {
+            if (encoder.profile->detentSize == 1)
+                callback(ch, encoder.getValue(), delta);
+            else if (encoder.detent != detent) // virtual detents: report crossings only
+                callback(ch, encoder.detent, encoder.detent - detent);
+        }
+        if (encoder.curState != state) // any edge counts as activity
+        {
+            activity();
+            if (encoder.profile->velocityDecay != 0) anyVelocity = true;
+        }
+    }
+
+    template <typename counter_t>
+    void EncPlexBase<counter_t>::decayVelocities()
+    {
+        if (!anyVelocity) return; // quiet ticks end here
+
+        anyVelocity = false;
+        for (unsigned ch = 0; ch < encoderCount; ch++)
+        {
+            encoders[ch].decayVelocity();
+            if (encoders[ch].velocity != 0) anyVelocity = true;
+        }
+    }
+
+    template <typename counter_t>
+    void EncPlexBase<counter_t>::checkFaults()
+    {
+        if (health == nullptr) return;
+
+        unsigned long now = TimeSource::now();
+        if (now == lastFaultCheck) return; // ms resolution is sufficient
+        lastFaultCheck = now;
+
+        bool windowDone = now - windowStart >= faultWindow;
+        if (windowDone) windowStart = now;
+
+        for (unsigned ch = 0; ch < encoderCount; ch++)
+        {
+            EncoderBase<counter_t>& encoder = encoders[ch];
+            health_t& h                     = health[ch];
+
+            if (h.faulted)
+            {
+                bool stable = false;
+                if (h.changed)
+                {
+                    h.changed = false;
+                    h.since   = now;
+                } else
+                    stable = now - h.since >= stuckTimeout;
+
+                if (h.input == 0xFF || !(stable || h.valid >= recoverTransitions)) continue; // no input seen yet / still moving
+
+                encoder.begin(h.input >> 1, h.input & 1); // resync
+                if (h.valid < recoverTransitions && encoder.subStepFraction(encoder.curState) != 0) continue; // resting between two detents, stays quarantined
+
+                encoder.errCount = 0;
+                h.since          = now;
+                h.faulted        = false;
+                if (faultCallback != nullptr) faultCallback(ch, false);
+                continue;
+            }
+
+            bool fault = false;
+            if (encoder.subStepFraction(encoder.curState) == 0)
+                h.since = now;
+            else
+                fault = now - h.since >= stuckTimeout; // stuck between two detents
+
+            if (windowDone)
+            {
+                fault            = fault || encoder.errCount > maxErrors;
+                encoder.errCount = 0;
+            }
+
+            if (fault)
+            {
+                h.faulted = true;
+                h.changed = false;
+                h.input   = 0xFF; // unknown, first sample counts as change
+                h.valid   = 0;
+                h.since   = now;
+                if (faultCallback != nullptr) faultCallback(ch, true);
+            }
+        }
+    }
+
     template <typename counter_t>
     void EncPlexBase<counter_t>::attachCallback(allCallback_t _callback)
     {
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "../HAL/directReadWrite.h"
+#include "EncPlexBase.h"
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Compile time description of a panel of directly connected encoders
+     *
+     *  using Panel = EncoderPanel<PanelChannel<2, 3>,                                   // A, B
+     *                             PanelChannel<4, 5, 6>,                                // A, B, button
+     *                             PanelChannel<7, 8, HAL::not_a_pin, CountMode::half, 0, 99, true>>; // limits 0..99 periodic
+     *  Panel panel;
+     *
+     *  Pins, count modes and limits are template parameters, tick() is
+     *  generated as straight line code (one block per channel) with
+     *  constant pins and without loops or bounds checks.
+     ************************************************************************/
+    template <uint8_t pinA, uint8_t pinB, uint8_t pinBtn = HAL::not_a_pin, CountMode countMode = CountMode::quarter, int minVal = 0, int maxVal = 0, bool periodic = false>
+    struct PanelChannel
+    {
+        using A   = HAL::FixedPin<pinA>;
+        using B   = HAL::FixedPin<pinB>;
+        using Btn = HAL::FixedPin<pinBtn>;
+
+        static constexpr bool hasButton = pinBtn != HAL::not_a_pin;
+        static constexpr CountMode mode = countMode;
+        static constexpr int min = minVal, max = maxVal; // min >= max: no limits
+        static constexpr bool isPeriodic = periodic;
+    };
+
+    namespace Panel_impl // C++11 replacement for std::index_sequence
+    {
+        template <size_t... I>
+        struct indices
+        {};
+
+        template <size_t N, size_t... I>
+        struct makeIndices : makeIndices<N - 1, N - 1, I...>
+        {};
+
+        template <size_t... I>
+        struct makeIndices<0, I...>
+        {
+            using type = indices<I...>;
+        };
+    }
+
+    template <typename counter_t, typename... Channels>
+    class EncoderPanel_tpl : public EncPlexBase<counter_t>
+    {
+     public:
+        static constexpr size_t channelCount = sizeof...(Channels);
+
+        EncoderPanel_tpl() : EncPlexBase<counter_t>(channelCount) {}
+
+        inline void begin(int inputMode = INPUT_PULLUP);
+        inline void tick(); // call as often as possible
+
+     protected:
+        using indices_t = typename Panel_impl::makeIndices<channelCount>::type;
+
+        template <size_t... I>
+        inline void beginChannels(Panel_impl::indices<I...>, int inputMode);
+        template <size_t... I>
+        inline void scanChannels(Panel_impl::indices<I...>, bool scanButtons);
+
+        template <size_t ch, typename channel_t>
+        inline void beginChannel(int inputMode);
+        template <size_t ch, typename channel_t>
+        inline void scanChannel(bool scanButtons);
+    };
+
+    // IMPLEMENTATION =====================================================================================================
+
+    template <typename counter_t, typename... Channels>
+    void EncoderPanel_tpl<counter_t, Channels...>::begin(int inputMode)
+    {
+        beginChannels(indices_t(), inputMode);
+    }
+
+    template <typename counter_t, typename... Channels>
+    void EncoderPanel_tpl<counter_t, Channels...>::tick()
+    {
+        this->decayVelocities(); // keeps decaying while idle
+        if (!this->idleScanDue()) return;
+
+        scanChannels(indices_t(), this->buttonScanDue());
+        this->checkIdle();
+        this->checkFaults();
+    }
+
+    template <typename counter_t, typename... Channels>
+    template <size_t... I>
+    void EncoderPanel_tpl<counter_t, Channels...>::beginChannels(Panel_impl::indices<I...>, int inputMode)
+    {
+        int expand[] = {0, (beginChannel<I, Channels>(inputMode), 0)...};
+        (void)expand;
+    }
+
+    template <typename counter_t, typename... Channels>
+    template <size_t... I>
+    void EncoderPanel_tpl<counter_t, Channels...>::scanChannels(Panel_impl::indices<I...>, bool scanButtons)
+    {
+        int expand[] = {0, (scanChannel<I, Channels>(scanButtons), 0)...}; // evaluated in order
+        (void)expand;
+    }
+
+    template <typename counter_t, typename... Channels>
+    template <size_t ch, typename channel_t>
+    void EncoderPanel_tpl<counter_t, Channels...>::beginChannel(int inputMode)
+    {
+        EncoderBase<counter_t>& encoder = EncPlexBase<counter_t>::encoders[ch];
+
+        channel_t::A::begin(inputMode);
+        channel_t::B::begin(inputMode);
+        if (channel_t::hasButton) channel_t::Btn::begin(inputMode);
+
+        encoder.setCountMode(channel_t::mode);
+        if (channel_t::min < channel_t::max) encoder.setLimits(channel_t::min, channel_t::max, channel_t::isPeriodic);
+        encoder.begin(channel_t::A::read(), channel_t::B::read()); // start state
+    }
+
+    template <typename counter_t, typename... Channels>
+    template <size_t ch, typename channel_t>
+    void EncoderPanel_tpl<counter_t, Channels...>::scanChannel(bool scanButtons)
+    {
+        if (channel_t::hasButton && scanButtons) // hasButton is a compile time constant
+            EncPlexBase<counter_t>::process(ch, channel_t::A::read(), channel_t::B::read(), channel_t::Btn::read());
+        else
+            EncPlexBase<counter_t>::process(ch, channel_t::A::read(), channel_t::B::read());
+    }
+
+    template <typename... Channels>
+    using EncoderPanel = EncoderPanel_tpl<int, Channels...>;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "EncPlexBase.h"
+
+#if defined(__AVR__)
+    #include <avr/pgmspace.h>
+#endif
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Binary configuration of all channels of a multiplexer, applied in
+     *  one pass. The blob can be stored in flash (PROGMEM) or received at
+     *  run time. Generate it with Resources/Extras/PanelConfig/panelconfig.py
+     *
+     *  PanelConfig config;                                // holds the profiles, needs to live as long as the plexer
+     *  encoders.begin();
+     *  config.apply(encoders, blob, sizeof(blob), true); // true: blob is in PROGMEM (AVR)
+     *
+     *  Format (version 1, little endian):
+     *    'E' 'C' version profileCount channelCount
+     *    profileCount x 20 bytes:
+     *      countMode(0xFF: keep) flags(1: limits, 2: periodic) acceleration detents detentHysteresis
+     *      reversalHysteresis outputMode decayShift min(int32) max(int32) stepSize(int32)
+     *    channelCount x profile index
+     *    checksum (sum of all bytes == 0 mod 256)
+     *
+     *  Nothing is changed if the blob is invalid, its channel count has to
+     *  match the plexer. Values are integers (counter_t(long)) and need to
+     *  fit counter_t, panelconfig.py --counter-bits 16 checks this for int
+     *  on AVR.
+     ************************************************************************/
+    template <typename counter_t>
+    class PanelConfig_tpl
+    {
+     public:
+        static constexpr uint8_t version       = 1;
+        static constexpr size_t headerSize     = 5;
+        static constexpr size_t profileSize    = 20;
+        static constexpr uint8_t keepCountMode = 0xFF; // profile without count mode
+
+        PanelConfig_tpl() = default;
+        ~PanelConfig_tpl() { delete[] profiles; }
+
+        inline bool apply(EncPlexBase<counter_t>& plex, const uint8_t* blob, size_t size, bool inFlash = false); // false: invalid blob
+
+        uint8_t getProfileCount() const { return profileCount; }
+
+     protected:
+        PanelConfig_tpl(PanelConfig_tpl const&)            = delete;
+        PanelConfig_tpl& operator=(PanelConfig_tpl const&) = delete;
+
+        static inline uint8_t readByte(const uint8_t* p, bool inFlash);
+        static inline int32_t readInt32(const uint8_t* p, bool inFlash);
+
+        EncoderProfile_tpl<counter_t>* profiles = nullptr;
+        uint8_t profileCount                    = 0;
+    };
+
+    // IMPLEMENTATION =====================================================================================================
+
+    template <typename counter_t>
+    bool PanelConfig_tpl<counter_t>::apply(EncPlexBase<counter_t>& plex, const uint8_t* blob, size_t size, bool inFlash)
+    {
+        if (blob == nullptr || size < headerSize + 1) return false;
+        if (readByte(blob, inFlash) != 'E' || readByte(blob + 1, inFlash) != 'C' || readByte(blob + 2, inFlash) != version) return false;
+
+        const uint8_t nrOfProfiles = readByte(blob + 3, inFlash);
+        const uint8_t nrOfChannels = readByte(blob + 4, inFlash);
+        const uint8_t* channels    = blob + headerSize + nrOfProfiles * profileSize;
+
+        if (size != headerSize + nrOfProfiles * profileSize + nrOfChannels + 1) return false;
+        if (nrOfChannels != plex.getEncoderCount() || nrOfProfiles == 0) return false;
+
+        uint8_t sum = 0;
+        for (size_t i = 0; i < size; i++) sum += readByte(blob + i, inFlash);
+        if (sum != 0) return false;
+
+        for (unsigned i = 0; i < nrOfProfiles; i++) // enum values in range
+        {
+            const uint8_t* r = blob + headerSize + i * profileSize;
+            uint8_t mode = readByte(r, inFlash);
+            if ((mode > (uint8_t)CountMode::full && mode != keepCountMode) || readByte(r + 2, inFlash) > (uint8_t)AccelerationMode::FAST || readByte(r + 6, inFlash) > (uint8_t)OutputMode::subStep) return false;
+        }
+        for (unsigned ch = 0; ch < nrOfChannels; ch++)
+        {
+            if (readByte(channels + ch, inFlash) >= nrOfProfiles) return false;
+        }
+
+        EncoderProfile_tpl<counter_t>* newProfiles = new EncoderProfile_tpl<counter_t>[nrOfProfiles];
+        for (unsigned i = 0; i < nrOfProfiles; i++)
+        {
+            const uint8_t* r                 = blob + headerSize + i * profileSize;
+            EncoderProfile_tpl<counter_t>& p = newProfiles[i];
+
+            uint8_t flags = readByte(r + 1, inFlash);
+            uint8_t mode  = readByte(r, inFlash);
+            if (mode != keepCountMode) p.setCountMode((CountMode)mode);
+            p.setAcceleration((AccelerationMode)readByte(r + 2, inFlash))
+                .setDetents(readByte(r + 3, inFlash), readByte(r + 4, inFlash))
+                .setReversalHysteresis(readByte(r + 5, inFlash))
+                .setOutputMode((OutputMode)readByte(r + 6, inFlash), readByte(r + 7, inFlash))
+                .setStepSize(counter_t((long)readInt32(r + 16, inFlash)));
+            if (flags & 0x01) p.setLimits(counter_t((long)readInt32(r + 8, inFlash)), counter_t((long)readInt32(r + 12, inFlash)), flags & 0x02);
+        }
+
+        unsigned first = 0; // apply runs of channels sharing a profile at once
+        for (unsigned ch = 1; ch <= nrOfChannels; ch++)
+        {
+            uint8_t idx = readByte(channels + first, inFlash);
+            if (ch < nrOfChannels && readByte(channels + ch, inFlash) == idx) continue;
+            plex.applyProfile(first, ch - first, newProfiles[idx]);
+            first = ch;
+        }
+
+        delete[] profiles; // no channel references the old profiles anymore
+        profiles     = newProfiles;
+        profileCount = nrOfProfiles;
+        return true;
+    }
+
+    template <typename counter_t>
+    uint8_t PanelConfig_tpl<counter_t>::readByte(const uint8_t* p, bool inFlash)
+    {
+#if defined(__AVR__)
+        if (inFlash) return pgm_read_byte(p);
+#endif
+        return *p;
+    }
+
+    template <typename counter_t>
+    int32_t PanelConfig_tpl<counter_t>::readInt32(const uint8_t* p, bool inFlash)
+    {
+        uint32_t v = (uint32_t)readByte(p, inFlash) | (uint32_t)readByte(p + 1, inFlash) << 8 |
+                     (uint32_t)readByte(p + 2, inFlash) << 16 | (uint32_t)readByte(p + 3, inFlash) << 24;
+        return (int32_t)v;
+    }
+
+    using PanelConfig = PanelConfig_tpl<int>;
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "../HAL/directReadWrite.h"
+#include "EncPlexBase.h"
+
+#if defined(HAL_HAS_PORT_ACCESS)
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Array of directly connected, polled encoders
+     *
+     *  PolledEncoderArray<8> encoders;
+     *  encoders.setPins(0, 2, 3);       // channel, A, B (, button)
+     *  ...
+     *  encoders.begin();
+     *  encoders.tick();                 // as often as possible
+     *
+     *  The pins are grouped by port. tick() reads each port once and only
+     *  decodes the channels whose A/B bits changed since the last tick,
+     *  i.e. a tick without movement costs one load and compare per port.
+     *  Buttons are grouped the same way, a button is only passed to its
+     *  debouncer if its bit changed or a debounce is pending.
+     *  The pins may be spread over any number of ports.
+     ************************************************************************/
+    template <size_t N, typename counter_t>
+    class PolledEncoderArray_tpl : public EncPlexBase<counter_t>
+    {
+     public:
+        using port_t = HAL::port_t;
+
+        PolledEncoderArray_tpl() : EncPlexBase<counter_t>(N) {}
+
+        inline bool setPins(unsigned channel, uint8_t pinA, uint8_t pinB, uint8_t pinBtn = HAL::not_a_pin, int inputMode = INPUT_PULLUP);
+        inline void begin(CountMode mode = CountMode::quarter); // call after setting the pins
+        inline void tick();                                     // call as often as possible
+
+     protected:
+        struct group_t
+        {
+            const volatile port_t* reg; // nullptr: no port registers (fallback HAL), pins are read one by one
+            port_t mask;                // encoder (or button) pins on this port
+            port_t last;
+            port_t pending;             // buttons whose debounced state differs from the input (buttons only)
+        };
+
+        struct channel_t
+        {
+            uint8_t groupA = 0xFF, groupB = 0xFF; // 0xFF: unused channel
+            uint8_t groupBtn = 0xFF;              // 0xFF: no button
+            port_t maskA = 0, maskB = 0, maskBtn = 0;
+            HAL::pinRegInfo_t A, B, btn;
+        };
+
+        inline uint8_t group(group_t* list, uint8_t& count, const HAL::pinRegInfo_t& pin); // finds or adds the group of the pin
+        inline port_t readGroup(uint8_t g) const;
+        inline port_t readButtons(uint8_t g) const;
+
+        group_t groups[2 * N];
+        uint8_t groupCount = 0;
+        group_t btnGroups[N];
+        uint8_t btnGroupCount = 0;
+        channel_t channels[N];
+    };
+
+    // IMPLEMENTATION =====================================================================================================
+
+    template <size_t N, typename counter_t>
+    bool PolledEncoderArray_tpl<N, counter_t>::setPins(unsigned ch, uint8_t pinA, uint8_t pinB, uint8_t pinBtn, int inputMode)
+    {
+        using namespace HAL;
+
+        if (ch >= N) return false;
+        pinRegInfo_t a(pinA), b(pinB);
+        if (portMask(a) == 0 || portMask(b) == 0) return false;
+
+        pinMode(pinA, inputMode);
+        pinMode(pinB, inputMode);
+
+        channel_t& c = channels[ch];
+        c.A          = a;
+        c.B          = b;
+        c.groupA     = group(groups, groupCount, a);
+        c.groupB     = group(groups, groupCount, b);
+        c.maskA      = portMask(a);
+        c.maskB      = portMask(b);
+        if (pinBtn != not_a_pin)
+        {
+            pinRegInfo_t btn(pinBtn);
+            if (portMask(btn) == 0) return false;
+            pinMode(pinBtn, inputMode);
+            c.btn      = btn;
+            c.groupBtn = group(btnGroups, btnGroupCount, btn);
+            c.maskBtn  = portMask(btn);
+            btnGroups[c.groupBtn].mask |= c.maskBtn;
+        }
+        groups[c.groupA].mask |= c.maskA;
+        groups[c.groupB].mask |= c.maskB;
+        return true;
+    }
+
+    template <size_t N, typename counter_t>
+    uint8_t PolledEncoderArray_tpl<N, counter_t>::group(group_t* list, uint8_t& count, const HAL::pinRegInfo_t& pin)
+    {
+        const volatile port_t* reg = HAL::portRegister(pin);
+        for (uint8_t g = 0; g < count; g++)
+        {
+            if (list[g].reg == reg) return g;
+        }
+        list[count] = {reg, 0, 0, 0}; // at most 2 * N different ports (N for buttons)
+        return count++;
+    }
+
+    template <size_t N, typename counter_t>
+    void PolledEncoderArray_tpl<N, counter_t>::begin(CountMode mode)
+    {
+        EncPlexBase<counter_t>::begin(mode);
+
+        for (uint8_t g = 0; g < groupCount; g++) groups[g].last = readGroup(g);
+        for (uint8_t g = 0; g < btnGroupCount; g++) // let the debouncers settle on the current state
+        {
+            btnGroups[g].last    = readButtons(g);
+            btnGroups[g].pending = btnGroups[g].mask;
+        }
+        for (unsigned ch = 0; ch < N; ch++) // capture start state of all encoders
+        {
+            const channel_t& c = channels[ch];
+            if (c.groupA == 0xFF) continue;
+            EncPlexBase<counter_t>::encoders[ch].begin((groups[c.groupA].last & c.maskA) != 0, (groups[c.groupB].last & c.maskB) != 0);
+        }
+    }
+
+    template <size_t N, typename counter_t>
+    typename PolledEncoderArray_tpl<N, counter_t>::port_t PolledEncoderArray_tpl<N, counter_t>::readGroup(uint8_t g) const
+    {
+        if (groups[g].reg != nullptr) return *groups[g].reg & groups[g].mask; // single load
+
+        port_t snapshot = 0;
+        for (unsigned ch = 0; ch < N; ch++)
+        {
+            const channel_t& c = channels[ch];
+            if (c.groupA == g && HAL::directRead(c.A)) snapshot |= c.maskA;
+            if (c.groupB == g && HAL::directRead(c.B)) snapshot |= c.maskB;
+        }
+        return snapshot;
+    }
+
+    template <size_t N, typename counter_t>
+    typename PolledEncoderArray_tpl<N, counter_t>::port_t PolledEncoderArray_tpl<N, counter_t>::readButtons(uint8_t g) const
+    {
+        if (btnGroups[g].reg != nullptr) return *btnGroups[g].reg & btnGroups[g].mask;
+
+        port_t snapshot = 0;
+        for (unsigned ch = 0; ch < N; ch++)
+        {
+            const channel_t& c = channels[ch];
+            if (c.groupBtn == g && HAL::directRead(c.btn)) snapshot |= c.maskBtn;
+        }
+        return snapshot;
+    }
+
+    template <size_t N, typename counter_t>
+    void PolledEncoderArray_tpl<N, counter_t>::tick()
+    {
+        this->decayVelocities(); // keeps decaying while idle
+        if (!this->idleScanDue()) return;
+
+        port_t changed[2 * N];
+        bool anyChange = false;
+        for (uint8_t g = 0; g < groupCount; g++)
+        {
+            port_t snapshot = readGroup(g);
+            changed[g]      = snapshot ^ groups[g].last;
+            groups[g].last  = snapshot;
+            anyChange |= changed[g] != 0;
+        }
+
+        port_t btnDue[N]; // buttons to pass to their debouncers
+        bool anyButton = false;
+        if (btnGroupCount != 0 && this->buttonScanDue())
+        {
+            for (uint8_t g = 0; g < btnGroupCount; g++)
+            {
+                port_t snapshot   = readButtons(g);
+                btnDue[g]         = (snapshot ^ btnGroups[g].last) | btnGroups[g].pending;
+                btnGroups[g].last = snapshot;
+                anyButton |= btnDue[g] != 0;
+            }
+        }
+
+        if (anyChange || anyButton) // quiet ticks end here
+        {
+            for (unsigned ch = 0; ch < N; ch++)
+            {
+                const channel_t& c = channels[ch];
+                if (c.groupA == 0xFF) continue;
+
+                uint8_t a = (groups[c.groupA].last & c.maskA) != 0;
+                uint8_t b = (groups[c.groupB].last & c.maskB) != 0;
+                if (anyButton && c.groupBtn != 0xFF && (btnDue[c.groupBtn] & c.maskBtn))
+                {
+                    group_t& g  = btnGroups[c.groupBtn];
+                    uint8_t btn = (g.last & c.maskBtn) != 0;
+                    EncPlexBase<counter_t>::process(ch, a, b, btn);
+                    if (this->encoders[ch].getButton() != btn)
+                        g.pending |= c.maskBtn;
+                    else
+                        g.pending &= ~c.maskBtn;
+                } else if ((changed[c.groupA] & c.maskA) | (changed[c.groupB] & c.maskB))
+                    EncPlexBase<counter_t>::process(ch, a, b);
+            }
+        }
+        this->checkIdle();
+        this->checkFaults();
+    }
+
+    template <size_t N>
+    using PolledEncoderArray = PolledEncoderArray_tpl<N, int>;
+}
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Arduino.h"
+#include <EEPROM.h>
+
+namespace EncoderTool
+{
+    // Storage adapter using the built in EEPROM (or its flash emulation on Teensy 4 / ESP)
+    // Use offset and length to reserve a part of the EEPROM for the encoder values.
+    class EEPROMStorage
+    {
+     public:
+        EEPROMStorage(size_t offset, size_t length)
+            : offset(offset), length(length) {}
+
+        size_t size() const { return length; }
+
+        void read(size_t addr, void* dst, size_t len)
+        {
+            uint8_t* d = (uint8_t*)dst;
+            for (size_t i = 0; i < len; i++) d[i] = EEPROM.read(offset + addr + i);
+        }
+
+        void write(size_t addr, const void* src, size_t len)
+        {
+            const uint8_t* s = (const uint8_t*)src;
+#if defined(ESP32) || defined(ESP8266)
+            for (size_t i = 0; i < len; i++) EEPROM.write(offset + addr + i, s[i]); // RAM copy, written to flash by commit()
+#else
+            for (size_t i = 0; i < len; i++) EEPROM.update(offset + addr + i, s[i]); // only writes changed bytes
+#endif
+        }
+
+        void commit() // once per record, each commit rewrites the whole flash sector on ESP
+        {
+#if defined(ESP32) || defined(ESP8266)
+            EEPROM.commit();
+#endif
+        }
+
+     protected:
+        const size_t offset, length;
+    };
+}
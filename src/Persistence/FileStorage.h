@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  File backed storage emulator for host side testing of the
+     *  PersistentState class. Unwritten memory reads as 0xFF like
+     *  erased flash/EEPROM. Counts read and written bytes and keeps track
+     *  of the wear of every cell so that write amplification and boot
+     *  time scan costs can be measured.
+     ************************************************************************/
+    class FileStorage
+    {
+     public:
+        FileStorage(const char* fileName, size_t length)
+            : length(length)
+        {
+            wear = new uint32_t[length]();
+            file = fopen(fileName, "r+b");
+            if (file == nullptr) // create an "erased" file
+            {
+                file = fopen(fileName, "w+b");
+                if (file == nullptr) return;
+                for (size_t i = 0; i < length; i++) fputc(0xFF, file);
+                fflush(file);
+            }
+        }
+
+        ~FileStorage()
+        {
+            if (file != nullptr) fclose(file);
+            delete[] wear;
+        }
+
+        size_t size() const { return length; }
+
+        void read(size_t addr, void* dst, size_t len)
+        {
+            memset(dst, 0xFF, len);
+            if (file == nullptr || addr + len > length) return;
+            fseek(file, (long)addr, SEEK_SET);
+            if (fread(dst, 1, len, file) != len) return;
+            bytesRead += len;
+            readCalls++;
+        }
+
+        void write(size_t addr, const void* src, size_t len)
+        {
+            if (file == nullptr || addr + len > length) return;
+            fseek(file, (long)addr, SEEK_SET);
+            fwrite(src, 1, len, file);
+            fflush(file);
+            for (size_t i = 0; i < len; i++) wear[addr + i]++;
+            bytesWritten += len;
+        }
+
+        void commit() { commits++; }
+
+        uint32_t getMaxWear() const // highest number of writes to a single cell
+        {
+            uint32_t max = 0;
+            for (size_t i = 0; i < length; i++)
+                if (wear[i] > max) max = wear[i];
+            return max;
+        }
+
+        unsigned long bytesRead = 0, bytesWritten = 0, readCalls = 0, commits = 0;
+
+     protected:
+        FILE* file;
+        const size_t length;
+        uint32_t* wear;
+    };
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include "../Multiplexed/EncPlexBase.h"
+#include "../TimeSource.h"
+#include <string.h>
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Stores the values of all encoders of a multiplexer in non volatile
+     *  memory and restores them after a power cycle.
+     *
+     *  - Changes are coalesced: a record is only written after the values
+     *    didn't change for 'idleWindow' ms.
+     *  - Records are appended round robin to the storage (wear levelling).
+     *    Each record carries a sequence number and a CRC16. On boot, the
+     *    newest valid record is found by a binary search over the slots.
+     *  - Writing is spread over several tick() calls (bytesPerTick) so that
+     *    slow EEPROM writes don't stall the loop.
+     *
+     *  The storage needs to provide:
+     *     size_t size() const;
+     *     void read(size_t addr, void* dst, size_t len);
+     *     void write(size_t addr, const void* src, size_t len);
+     *     void commit();      // called once per completed record (e.g. EEPROM.commit() on ESP)
+     *  See EEPROMStorage.h and FileStorage.h
+     ************************************************************************/
+    template <typename counter_t, typename storage_t>
+    class PersistentState_tpl
+    {
+     public:
+        inline PersistentState_tpl(EncPlexBase<counter_t>& plexer, storage_t& storage, unsigned idleWindow = 2000, unsigned bytesPerTick = 8);
+        inline ~PersistentState_tpl();
+
+        inline bool restore(); // restores the plexer values from the newest valid record (plexer.begin() doesn't touch the values)
+        inline void tick();    // call as often as possible (e.g. in loop)
+        inline void flush();   // immediately writes pending changes (blocking)
+
+        bool isWriting() const { return writePos < slotSize; }
+        size_t getSlotCount() const { return slotCount; }
+
+     protected:
+        struct header_t
+        {
+            uint8_t magic;
+            uint8_t count;
+            uint16_t seq;
+        };
+        static constexpr uint8_t magic = 0xE5;
+
+        inline bool readSlot(size_t slot, uint16_t* seq, uint8_t* buf);
+        inline void prepareRecord();
+        inline void writeChunk(size_t len);
+        inline static uint16_t crc16(const uint8_t* data, size_t len);
+
+        EncPlexBase<counter_t>& plexer;
+        storage_t& storage;
+
+        const size_t count;
+        const size_t slotSize;  // header + values + crc
+        const size_t slotCount; // number of records fitting in the storage
+
+        unsigned idleWindow, bytesPerTick;
+        unsigned long lastChange = 0;
+        bool dirty               = false;
+
+        counter_t* snapshot; // last seen values
+        uint8_t* record;     // record currently being written
+        size_t writeSlot = 0, writePos;
+        size_t lastSlot  = 0;
+        uint16_t lastSeq = 0;
+        bool hasRecord   = false;
+    };
+
+    // IMPLEMENTATION =====================================================================================================
+
+    template <typename counter_t, typename storage_t>
+    PersistentState_tpl<counter_t, storage_t>::PersistentState_tpl(EncPlexBase<counter_t>& _plexer, storage_t& _storage, unsigned _idleWindow, unsigned _bytesPerTick)
+        : plexer(_plexer), storage(_storage),
+          count(_plexer.getEncoderCount() < 255 ? _plexer.getEncoderCount() : 255),
+          slotSize(sizeof(header_t) + count * sizeof(counter_t) + sizeof(uint16_t)),
+          slotCount(_storage.size() / slotSize),
+          idleWindow(_idleWindow), bytesPerTick(_bytesPerTick > 0 ? _bytesPerTick : 1)
+    {
+        snapshot = new counter_t[count]();
+        record   = new uint8_t[slotSize];
+        writePos = slotSize; // nothing to write
+    }
+
+    template <typename counter_t, typename storage_t>
+    PersistentState_tpl<counter_t, storage_t>::~PersistentState_tpl()
+    {
+        delete[] snapshot;
+        delete[] record;
+    }
+
+    template <typename counter_t, typename storage_t>
+    bool PersistentState_tpl<counter_t, storage_t>::readSlot(size_t slot, uint16_t* seq, uint8_t* buf)
+    {
+        storage.read(slot * slotSize, buf, slotSize);
+
+        header_t hdr;
+        memcpy(&hdr, buf, sizeof(header_t));
+        if (hdr.magic != magic || hdr.count != count) return false;
+
+        uint16_t crc;
+        memcpy(&crc, buf + slotSize - sizeof(uint16_t), sizeof(uint16_t));
+        if (crc != crc16(buf, slotSize - sizeof(uint16_t))) return false;
+
+        *seq = hdr.seq;
+        return true;
+    }
+
+    template <typename counter_t, typename storage_t>
+    bool PersistentState_tpl<counter_t, storage_t>::restore()
+    {
+        if (slotCount == 0) return false;
+
+        uint16_t seq;
+        hasRecord = false;
+
+        // Records are written round robin, i.e. if slot 0 holds sequence number s0, slots 0..k hold s0..s0+k
+        // and all later slots hold older records (or nothing). Binary search for the last slot following this pattern.
+        uint16_t s0;
+        if (readSlot(0, &s0, record))
+        {
+            size_t lo = 0, hi = slotCount; // slot lo is known to be good, hi is known to be bad
+            while (hi - lo > 1)
+            {
+                size_t mid = lo + (hi - lo) / 2;
+                if (readSlot(mid, &seq, record) && seq == (uint16_t)(s0 + mid))
+                    lo = mid;
+                else
+                    hi = mid;
+            }
+            lastSlot  = lo;
+            lastSeq   = (uint16_t)(s0 + lo);
+            hasRecord = true;
+        } else // slot 0 empty or torn (e.g. power loss while overwriting it) -> linear scan
+        {
+            for (size_t slot = 1; slot < slotCount; slot++)
+            {
+                if (readSlot(slot, &seq, record) && (!hasRecord || (int16_t)(seq - lastSeq) > 0))
+                {
+                    lastSlot  = slot;
+                    lastSeq   = seq;
+                    hasRecord = true;
+                }
+            }
+        }
+        if (!hasRecord) return false;
+
+        readSlot(lastSlot, &seq, record);
+        const uint8_t* src = record + sizeof(header_t);
+        for (size_t i = 0; i < count; i++, src += sizeof(counter_t))
+        {
+            memcpy(&snapshot[i], src, sizeof(counter_t));
+            plexer[i].setValue(snapshot[i]);
+        }
+        dirty = false;
+        return true;
+    }
+
+    template <typename counter_t, typename storage_t>
+    void PersistentState_tpl<counter_t, storage_t>::tick()
+    {
+        if (writePos < slotSize) // pending record, write next chunk
+        {
+            writeChunk(bytesPerTick);
+            return;
+        }
+
+        unsigned long now = TimeSource::now();
+        for (size_t i = 0; i < count; i++)
+        {
+            counter_t v = plexer[i].getValue();
+            if (v != snapshot[i])
+            {
+                snapshot[i] = v;
+                dirty       = true;
+                lastChange  = now;
+            }
+        }
+
+        if (dirty && now - lastChange >= idleWindow)
+        {
+            prepareRecord();
+            writeChunk(bytesPerTick);
+        }
+    }
+
+    template <typename counter_t, typename storage_t>
+    void PersistentState_tpl<counter_t, storage_t>::flush()
+    {
+        if (writePos >= slotSize)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                counter_t v = plexer[i].getValue();
+                if (v != snapshot[i])
+                {
+                    snapshot[i] = v;
+                    dirty       = true;
+                }
+            }
+            if (!dirty) return;
+            prepareRecord();
+        }
+        writeChunk(slotSize);
+    }
+
+    template <typename counter_t, typename storage_t>
+    void PersistentState_tpl<counter_t, storage_t>::prepareRecord()
+    {
+        if (slotCount == 0) return;
+
+        writeSlot = hasRecord ? (lastSlot + 1) % slotCount : 0;
+        header_t hdr{magic, (uint8_t)count, (uint16_t)(hasRecord ? lastSeq + 1 : 0)};
+
+        memcpy(record, &hdr, sizeof(header_t));
+        memcpy(record + sizeof(header_t), snapshot, count * sizeof(counter_t));
+        uint16_t crc = crc16(record, slotSize - sizeof(uint16_t));
+        memcpy(record + slotSize - sizeof(uint16_t), &crc, sizeof(uint16_t));
+
+        writePos = 0;
+        dirty    = false;
+    }
+
+    template <typename counter_t, typename storage_t>
+    void PersistentState_tpl<counter_t, storage_t>::writeChunk(size_t len)
+    {
+        if (len > slotSize - writePos) len = slotSize - writePos;
+        storage.write(writeSlot * slotSize + writePos, record + writePos, len);
+        writePos += len;
+
+        if (writePos >= slotSize) // record complete
+        {
+            storage.commit();
+
+            header_t hdr;
+            memcpy(&hdr, record, sizeof(header_t));
+            lastSeq   = hdr.seq;
+            lastSlot  = writeSlot;
+            hasRecord = true;
+        }
+    }
+
+    template <typename counter_t, typename storage_t>
+    uint16_t PersistentState_tpl<counter_t, storage_t>::crc16(const uint8_t* data, size_t len) // CRC-16/CCITT-FALSE
+    {
+        uint16_t crc = 0xFFFF;
+        while (len--)
+        {
+            crc ^= (uint16_t)(*data++) << 8;
+            for (uint8_t bit = 0; bit < 8; bit++)
+            {
+                crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+            }
+        }
+        return crc;
+    }
+
+    template <typename storage_t>
+    using PersistentState = PersistentState_tpl<int, storage_t>;
+
+} // namespace EncoderTool
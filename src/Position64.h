@@ -0,0 +1,71 @@
+#pragma once
+
+#include "EncoderBase.h"
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  64 bit position for multi turn axes, assembled from the native
+     *  width value of an encoder (low word) and a high word kept here.
+     *
+     *  The encoder (often running in an ISR) only counts its normal value
+     *  and posts a carry when the value wraps around. read() folds the
+     *  carries into the high word in the main context. I.e., the ISR cost
+     *  stays the one of a 16/32 bit counter.
+     *
+     *  - The encoder must count unbounded (no limits set)
+     *  - read() needs to be called at least every 127 wraps of the
+     *    encoder value (2^15 * 127 steps for 16 bit counters)
+     *  - Use set() instead of encoder.setValue() to preset the position
+     ************************************************************************/
+    template <typename counter_t>
+    class Position64_tpl
+    {
+     public:
+        Position64_tpl(EncoderBase<counter_t>& enc) : encoder(enc), lastCarry(enc.carry) {}
+
+        inline int64_t read(); // main context only
+        inline void set(int64_t position);
+
+     protected:
+        static constexpr int64_t wrapSize = INT64_C(1) << (8 * sizeof(counter_t)); // 2^bits
+
+        EncoderBase<counter_t>& encoder;
+        uint8_t lastCarry;
+        int64_t high = 0; // sum of the folded wraps * wrapSize
+
+        static_assert(std::numeric_limits<counter_t>::is_integer && sizeof(counter_t) < sizeof(int64_t), "Position64 requires an integral counter type narrower than 64 bit");
+    };
+
+    // INLINE IMPLEMENTATION ==========================================================================
+
+    template <typename counter_t>
+    int64_t Position64_tpl<counter_t>::read()
+    {
+        uint8_t carry;
+        counter_t low;
+        do // carry and value are changed by the encoder which might run in an ISR -> retry if a wrap happened while reading
+        {
+            carry = encoder.carry;
+            low   = encoder.getValue();
+        } while (carry != encoder.carry);
+
+        high += (int8_t)(uint8_t)(carry - lastCarry) * wrapSize;
+        lastCarry = carry;
+        return high + low;
+    }
+
+    template <typename counter_t>
+    void Position64_tpl<counter_t>::set(int64_t position)
+    {
+        counter_t low = (counter_t)position; // two's complement truncation
+        ATOMIC()
+        {
+            encoder.value = low;
+            lastCarry     = encoder.carry;
+        }
+        high = position - low;
+    }
+
+    using Position64 = Position64_tpl<int>;
+}
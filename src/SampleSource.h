@@ -0,0 +1,118 @@
+#pragma once
+
+#include "EncoderBase.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#if !defined(ARDUINO)
+    #include <stdio.h>
+#endif
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Sample sources feed input samples into the decoder core. A source
+     *  is any type providing
+     *
+     *      static constexpr bool live;  // true: one fresh sample per tick (pins)
+     *                                   // false: recorded, drained by tick() (buffers, files)
+     *      bool next(Sample& sample);   // false if no (more) samples are available
+     *
+     *  SourcedEncoder_tpl<counter_t, source_t> decodes the samples of any
+     *  source. This header and the core (EncoderBase.h, see EncoderCore.h)
+     *  don't depend on Arduino, i.e., they compile on a host as well.
+     *  Sources for pins live in Sampling/PinSource.h.
+     ************************************************************************/
+    struct Sample
+    {
+        uint8_t a, b, btn;
+
+        static Sample unpack(uint8_t s) { return {(uint8_t)((s >> 1) & 1), (uint8_t)(s & 1), (uint8_t)((s >> 2) & 1)}; } // bit 1: A, bit 0: B, bit 2: button
+    };
+
+    class BufferSource // memory or simulated bank, one packed sample (see Sample::unpack) per byte
+    {
+     public:
+        static constexpr bool live = false;
+
+        BufferSource(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+        bool next(Sample& sample)
+        {
+            if (pos >= size) return false;
+            sample = Sample::unpack(data[pos++]);
+            return true;
+        }
+        void rewind() { pos = 0; }
+
+     protected:
+        const uint8_t* data;
+        size_t size, pos = 0;
+    };
+
+#if !defined(ARDUINO)
+    class TraceFileSource // recorded trace file (host only), one packed sample per byte
+    {
+     public:
+        static constexpr bool live = false;
+
+        TraceFileSource(FILE* file) : file(file) {}
+
+        bool next(Sample& sample)
+        {
+            int c = file != nullptr ? fgetc(file) : EOF;
+            if (c == EOF) return false;
+            sample = Sample::unpack((uint8_t)c);
+            return true;
+        }
+
+     protected:
+        FILE* file;
+    };
+#endif
+
+    template <typename counter_t, typename source_t>
+    class SourcedEncoder_tpl : public EncoderBase<counter_t>
+    {
+     public:
+        SourcedEncoder_tpl(source_t& source) : source(source) {}
+
+        inline bool begin(CountMode mode = CountMode::quarter); // takes the first sample as start state, false if none available
+        inline size_t tick();                                   // decodes the available samples, returns their number
+
+     protected:
+        source_t& source;
+    };
+
+    // INLINE IMPLEMENTATION ==========================================================================
+
+    template <typename counter_t, typename source_t>
+    bool SourcedEncoder_tpl<counter_t, source_t>::begin(CountMode mode)
+    {
+        Sample s;
+        if (!source.next(s)) return false;
+
+        EncoderBase<counter_t>::setCountMode(mode);
+        EncoderBase<counter_t>::begin(s.a, s.b);
+        EncoderBase<counter_t>::updateButton(s.btn);
+        return true;
+    }
+
+    template <typename counter_t, typename source_t>
+    size_t SourcedEncoder_tpl<counter_t, source_t>::tick()
+    {
+        Sample s;
+        size_t n = 0;
+        while (source.next(s))
+        {
+            EncoderBase<counter_t>::update(s.a, s.b, s.btn);
+            EncoderBase<counter_t>::decayVelocity(); // one tick per sample
+            n++;
+            if (source_t::live) break; // compile time constant
+        }
+        return n;
+    }
+
+    template <typename source_t>
+    using SourcedEncoder = SourcedEncoder_tpl<int, source_t>;
+}
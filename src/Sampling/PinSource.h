@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../HAL/directReadWrite.h"
+#include "../SampleSource.h"
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Live sample source reading A, B and an optional button from digital
+     *  pins, see SampleSource.h
+     *
+     *  PinSource pins(2, 3, 4);
+     *  SourcedEncoder<PinSource> encoder(pins);
+     *  encoder.begin();      // in setup()
+     *  encoder.tick();       // as often as possible
+     ************************************************************************/
+    class PinSource
+    {
+     public:
+        static constexpr bool live = true;
+
+        PinSource(uint8_t pinA, uint8_t pinB, uint8_t pinBtn = HAL::not_a_pin, int inputMode = INPUT_PULLUP)
+        {
+            pinMode(pinA, inputMode);
+            pinMode(pinB, inputMode);
+            piA = HAL::getPinRegInfo(pinA);
+            piB = HAL::getPinRegInfo(pinB);
+
+            hasButton = pinBtn != HAL::not_a_pin;
+            if (hasButton)
+            {
+                pinMode(pinBtn, inputMode);
+                piBtn = HAL::getPinRegInfo(pinBtn);
+            }
+        }
+
+        bool next(Sample& sample)
+        {
+            using HAL::directRead;
+
+            sample.a   = directRead(piA);
+            sample.b   = directRead(piB);
+            sample.btn = hasButton ? directRead(piBtn) : LOW; // no button: idle state of the debouncer, as in PolledEncoder
+            return true;
+        }
+
+     protected:
+        HAL::pinRegInfo_t piA, piB, piBtn;
+        bool hasButton;
+    };
+}
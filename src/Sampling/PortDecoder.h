@@ -0,0 +1,136 @@
+#pragma once
+
+#include "../HAL/directReadWrite.h"
+#include "../Multiplexed/EncPlexBase.h"
+
+#if defined(HAL_HAS_PORT_ACCESS)
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Common base of the port based front ends (PortSampler, PortInterruptBank)
+     *
+     *  All encoder pins are on one GPIO port. A snapshot of the port holds
+     *  the A/B signals of all encoders, decode() compares it to the last
+     *  one and only processes the encoders whose bits changed.
+     ************************************************************************/
+    template <typename counter_t>
+    class PortDecoder_tpl : public EncPlexBase<counter_t>
+    {
+     public:
+        using port_t = HAL::port_t;
+
+        inline bool setPins(unsigned channel, int pinA, int pinB, int inputMode = INPUT_PULLUP); // false if not on the port of the other pins
+
+        const volatile port_t* getPortRegister() const { return port; }
+
+     protected:
+        inline PortDecoder_tpl(unsigned encoderCount, bool forDma = false); // forDma: use the DMA readable port (Teensy 4: GPIO1..4)
+        inline ~PortDecoder_tpl();
+
+        inline void begin(CountMode mode); // captures the start state of all encoders
+        inline port_t readPort() const;    // snapshot of the encoder pins
+        inline void decode(port_t snapshot);
+
+        HAL::pinRegInfo_t *A, *B;
+        const volatile port_t* port = nullptr; // nullptr: no port register (fallback HAL), pins are read one by one
+        bool hasPort                = false;
+        const bool forDma;
+        port_t *maskA, *maskB;
+        port_t usedMask = 0; // all encoder pins
+        port_t last     = 0; // last decoded snapshot
+    };
+
+    // IMPLEMENTATION =====================================================================================================
+
+    template <typename counter_t>
+    PortDecoder_tpl<counter_t>::PortDecoder_tpl(unsigned encoderCount, bool _forDma)
+        : EncPlexBase<counter_t>(encoderCount), forDma(_forDma)
+    {
+        A     = new HAL::pinRegInfo_t[encoderCount];
+        B     = new HAL::pinRegInfo_t[encoderCount];
+        maskA = new port_t[encoderCount]();
+        maskB = new port_t[encoderCount]();
+    }
+
+    template <typename counter_t>
+    PortDecoder_tpl<counter_t>::~PortDecoder_tpl()
+    {
+        delete[] A;
+        delete[] B;
+        delete[] maskA;
+        delete[] maskB;
+    }
+
+    template <typename counter_t>
+    bool PortDecoder_tpl<counter_t>::setPins(unsigned channel, int pinA, int pinB, int inputMode)
+    {
+        using namespace HAL;
+
+        if (channel >= EncPlexBase<counter_t>::encoderCount) return false;
+
+        pinRegInfo_t a(pinA), b(pinB);
+        const volatile port_t* reg = forDma ? dmaPortRegister(a) : portRegister(a);
+        if (portMask(a) == 0 || portMask(b) == 0 || portRegister(a) != portRegister(b)) return false;
+        if (hasPort && reg != port) return false;
+
+        port    = reg;
+        hasPort = true;
+
+        pinMode(pinA, inputMode);
+        pinMode(pinB, inputMode);
+        if (forDma)
+        {
+            routeToDmaPort(a);
+            routeToDmaPort(b);
+        }
+        A[channel]     = a;
+        B[channel]     = b;
+        maskA[channel] = portMask(a);
+        maskB[channel] = portMask(b);
+        usedMask |= maskA[channel] | maskB[channel];
+        return true;
+    }
+
+    template <typename counter_t>
+    void PortDecoder_tpl<counter_t>::begin(CountMode mode)
+    {
+        EncPlexBase<counter_t>::begin(mode);
+
+        last = readPort();
+        for (unsigned i = 0; i < EncPlexBase<counter_t>::encoderCount; i++) // capture start state of all encoders
+        {
+            if (maskA[i] == 0) continue;
+            EncPlexBase<counter_t>::encoders[i].begin((last & maskA[i]) != 0, (last & maskB[i]) != 0);
+        }
+    }
+
+    template <typename counter_t>
+    typename PortDecoder_tpl<counter_t>::port_t PortDecoder_tpl<counter_t>::readPort() const
+    {
+        if (port != nullptr) return *port & usedMask; // single load
+
+        port_t snapshot = 0;
+        for (unsigned i = 0; i < EncPlexBase<counter_t>::encoderCount; i++)
+        {
+            if (maskA[i] == 0) continue;
+            if (HAL::directRead(A[i])) snapshot |= maskA[i];
+            if (HAL::directRead(B[i])) snapshot |= maskB[i];
+        }
+        return snapshot;
+    }
+
+    template <typename counter_t>
+    void PortDecoder_tpl<counter_t>::decode(port_t snapshot)
+    {
+        port_t changed = snapshot ^ last;
+        last           = snapshot;
+
+        for (unsigned i = 0; i < EncPlexBase<counter_t>::encoderCount; i++)
+        {
+            if ((changed & (maskA[i] | maskB[i])) == 0) continue;
+            EncPlexBase<counter_t>::process(i, (snapshot & maskA[i]) != 0, (snapshot & maskB[i]) != 0);
+        }
+    }
+}
+#endif
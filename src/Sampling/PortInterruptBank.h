@@ -0,0 +1,132 @@
+#pragma once
+
+#include "PortDecoder.h"
+
+#if defined(HAL_HAS_PORT_ACCESS)
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Interrupt driven bank of directly connected encoders on one port
+     *
+     *  Each edge on any encoder pin triggers one interrupt which reads the
+     *  whole port at once and decodes only the encoders whose bits changed.
+     *
+     *  AVR: uses the pin change interrupt (PCINT) of the port, i.e. an Uno
+     *  can run 8 interrupt driven encoders. The ISR needs to be defined by
+     *  the sketch:
+     *
+     *      PortInterruptBank bank(4);
+     *      ISR(PCINT2_vect) { bank.onPortChange(); } // PCINT2: pins 0..7 on an Uno
+     *
+     *      bank.setPins(0, 2, 3); ...                // all pins on the same port / PCINT group
+     *      bank.begin();
+     *
+     *  Other boards: the handler is attached to all encoder pins, the pins
+     *  share the (port level) GPIO interrupt of the core:
+     *
+     *      bank.begin(CountMode::quarter, [] { bank.onPortChange(); });
+     *
+     *  Callbacks are invoked from the ISR. Call tick() from loop() if you
+     *  use the line fault detection.
+     ************************************************************************/
+    template <typename counter_t>
+    class PortInterruptBank_tpl : public PortDecoder_tpl<counter_t>
+    {
+     public:
+        using isr_t = void (*)();
+
+        PortInterruptBank_tpl(unsigned encoderCount) : PortDecoder_tpl<counter_t>(encoderCount) {}
+        ~PortInterruptBank_tpl() { end(); }
+
+        inline bool begin(CountMode mode = CountMode::quarter, isr_t isr = nullptr); // call after setting the pins, false if the pins don't support the interrupt
+        inline void end();                                                            // disables the interrupts
+
+        inline void onPortChange(); // call from the ISR: one port read, decodes the changed encoders
+        inline void tick();         // optional, fault detection bookkeeping
+
+     protected:
+        template <typename F>
+        inline void forEachPin(F f);
+        bool attached = false;
+    };
+
+    // IMPLEMENTATION =====================================================================================================
+
+    template <typename counter_t>
+    template <typename F>
+    void PortInterruptBank_tpl<counter_t>::forEachPin(F f)
+    {
+        for (unsigned i = 0; i < EncPlexBase<counter_t>::encoderCount; i++)
+        {
+            if (this->maskA[i] == 0) continue;
+            f(this->A[i].pin);
+            f(this->B[i].pin);
+        }
+    }
+
+    template <typename counter_t>
+    bool PortInterruptBank_tpl<counter_t>::begin(CountMode mode, isr_t isr)
+    {
+        end();
+        PortDecoder_tpl<counter_t>::begin(mode);
+        if (!this->hasPort) return false;
+
+#if defined(__AVR__) && defined(digitalPinToPCICR)
+        (void)isr;
+        bool valid    = true;
+        uint8_t group = 0xFF;
+        forEachPin([&](uint8_t pin) {
+            if (digitalPinToPCICR(pin) == 0 || (group != 0xFF && digitalPinToPCICRbit(pin) != group)) valid = false;
+            group = digitalPinToPCICRbit(pin);
+        });
+        if (!valid) return false;
+
+        ATOMIC()
+        {
+            forEachPin([](uint8_t pin) { *digitalPinToPCMSK(pin) |= _BV(digitalPinToPCMSKbit(pin)); });
+            PCIFR = _BV(group); // discard pending requests
+            PCICR |= _BV(group);
+        }
+#else
+        if (isr == nullptr) return false;
+        forEachPin([isr](uint8_t pin) { attachInterrupt(digitalPinToInterrupt(pin), isr, CHANGE); });
+#endif
+        attached = true;
+        return true;
+    }
+
+    template <typename counter_t>
+    void PortInterruptBank_tpl<counter_t>::end()
+    {
+        if (!attached) return;
+#if defined(__AVR__) && defined(digitalPinToPCICR)
+        ATOMIC()
+        {
+            forEachPin([](uint8_t pin) { *digitalPinToPCMSK(pin) &= ~_BV(digitalPinToPCMSKbit(pin)); }); // other pins of the group keep working
+        }
+#else
+        forEachPin([](uint8_t pin) { detachInterrupt(digitalPinToInterrupt(pin)); });
+#endif
+        attached = false;
+    }
+
+    template <typename counter_t>
+    void PortInterruptBank_tpl<counter_t>::onPortChange()
+    {
+        typename PortDecoder_tpl<counter_t>::port_t snapshot = this->readPort();
+        if (snapshot != this->last) this->decode(snapshot); // changes on other pins of the port end here
+    }
+
+    template <typename counter_t>
+    void PortInterruptBank_tpl<counter_t>::tick()
+    {
+        ATOMIC() // decoding runs in the ISR
+        {
+            this->checkFaults();
+        }
+    }
+
+    using PortInterruptBank = PortInterruptBank_tpl<int>;
+}
+#endif
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "PortDecoder.h"
+
+#if defined(HAL_HAS_PORT_ACCESS)
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Batch decoder for a ring buffer of GPIO port snapshots
+     *
+     *  A producer (e.g. a timer triggered DMA channel on Teensy 4 or SAMD)
+     *  copies the input register of a port into 'ring' at a fixed rate.
+     *  tick(head) decodes all snapshots written since the last call, where
+     *  'head' is the ring index the producer will write next. Setting up
+     *  the DMA is board specific and left to the user, the source address
+     *  is available from getPortRegister(). On Teensy 4 setPins() routes
+     *  the pins from the fast GPIO6..9 to GPIO1..4 which DMA can read,
+     *  getPortRegister() returns the GPIO1..4 register.
+     *
+     *  All encoder pins need to be on the same port. Snapshots without a
+     *  change on the encoder pins are skipped by a single compare.
+     ************************************************************************/
+    template <typename counter_t>
+    class PortSampler_tpl : public PortDecoder_tpl<counter_t>
+    {
+     public:
+        using port_t = HAL::port_t;
+
+        inline PortSampler_tpl(unsigned encoderCount, const volatile port_t* ring, size_t ringSize);
+
+        inline void begin(CountMode mode = CountMode::quarter, size_t head = 0); // call after setting the pins
+        inline void tick(size_t head);                                           // decodes ring[tail] ... ring[head - 1]
+
+     protected:
+        const volatile port_t* const ring;
+        const size_t ringSize;
+        size_t tail = 0;
+    };
+
+    // IMPLEMENTATION =====================================================================================================
+
+    template <typename counter_t>
+    PortSampler_tpl<counter_t>::PortSampler_tpl(unsigned encoderCount, const volatile port_t* _ring, size_t _ringSize)
+        : PortDecoder_tpl<counter_t>(encoderCount, true), ring(_ring), ringSize(_ringSize)
+    {
+    }
+
+    template <typename counter_t>
+    void PortSampler_tpl<counter_t>::begin(CountMode mode, size_t head)
+    {
+        PortDecoder_tpl<counter_t>::begin(mode);
+        tail = head < ringSize ? head : 0;
+    }
+
+    template <typename counter_t>
+    void PortSampler_tpl<counter_t>::tick(size_t head)
+    {
+        if (head >= ringSize) return;
+
+        while (tail != head)
+        {
+            port_t snapshot = ring[tail] & this->usedMask;
+            if (snapshot != this->last) this->decode(snapshot); // most snapshots don't change
+            this->decayVelocities();                            // one tick per snapshot
+            if (++tail == ringSize) tail = 0;
+        }
+        this->checkFaults();
+    }
+
+    using PortSampler = PortSampler_tpl<int>;
+}
+#endif
@@ -2,6 +2,7 @@
 
 #include "../EncoderBase.h"
 #include "../HAL/directReadWrite.h"
+#include "../HAL/oneShotTimer.h"
 #include "../HAL/pinInterruptHelper.h"
 
 #if defined(CORE_NUM_INTERRUPT)
@@ -11,6 +12,14 @@ namespace EncoderTool
     /***********************************************************************
      *  Simple interrupt based encoder implementation which reads
      *  phase A and B from two interrupt capable pins
+     *
+     *  Edge blanking: setBlanking(us) masks the pin interrupts after an
+     *  edge. A one shot timer (IntervalTimer) samples both pins once the
+     *  blanking time is over and re-arms the interrupts, i.e. a bouncing
+     *  contact costs one short ISR instead of one decoding ISR per bounce.
+     *  The blanking time needs to be shorter than the shortest time between
+     *  two transitions. Boards without timer support (and encoders which
+     *  don't get a timer) decode every edge as before.
      ************************************************************************/
     template <typename counter_t>
     class Encoder_tpl : public EncoderBase<counter_t>
@@ -21,12 +30,21 @@ namespace EncoderTool
         inline bool begin(int pinA, int pinB, CountMode = CountMode::quarter, int inputMode = INPUT_PULLUP);
         void doUpdate() { EncoderBase<counter_t>::update(HAL::directRead(A), HAL::directRead(B)); }
 
-
+        inline bool setBlanking(unsigned microseconds); // 0: off (default), false if no timer is available
 
      protected:
+        inline void onEdge();    // pin ISR
+        inline void onSettled(); // timer ISR, end of the blanking time
+        inline void arm();
+
         HAL::pinRegInfo_t A, B;
 
-        using iHelper = HAL::PinInterruptHelper<Encoder_tpl, &Encoder_tpl::doUpdate>;
+        unsigned blankTime = 0;
+
+        using iHelper = HAL::PinInterruptHelper<Encoder_tpl, &Encoder_tpl::onEdge>;
+#if defined(HAL_HAS_ONESHOT_TIMER)
+        using tHelper = HAL::OneShotTimer<Encoder_tpl, &Encoder_tpl::onSettled>;
+#endif
     };
 
     // Inline implementation ===============================================
@@ -55,9 +73,56 @@ namespace EncoderTool
         EncoderBase<counter_t>::setCountMode(countMode);
         EncoderBase<counter_t>::begin(directRead(A), directRead(B)); // set start state
 
+        arm();
+        return true;
+    }
+
+    template <typename counter_t>
+    void Encoder_tpl<counter_t>::arm()
+    {
         iHelper::attachInterrupt(A.pin, this, CHANGE);
         iHelper::attachInterrupt(B.pin, this, CHANGE);
+    }
+
+    template <typename counter_t>
+    bool Encoder_tpl<counter_t>::setBlanking(unsigned microseconds)
+    {
+#if defined(HAL_HAS_ONESHOT_TIMER)
+        if (microseconds != 0 && !tHelper::reserve(this)) return false; // all relays in use, keeps the current setting
+
+        if (microseconds == 0 && blankTime != 0)
+        {
+            tHelper::release(this);             // stops a running blanking period...
+            if (A.pin != HAL::not_a_pin) arm(); // ...which would have re-armed the interrupts
+        }
+        blankTime = microseconds;
         return true;
+#else
+        blankTime = 0; // no timer to re-arm the interrupts
+        return microseconds == 0;
+#endif
+    }
+
+    template <typename counter_t>
+    void Encoder_tpl<counter_t>::onEdge()
+    {
+#if defined(HAL_HAS_ONESHOT_TIMER)
+        if (blankTime != 0)
+        {
+            iHelper::detachInterrupt(A.pin); // mask until the contacts settled
+            iHelper::detachInterrupt(B.pin);
+            if (tHelper::start(this, blankTime)) return;
+            arm(); // all hardware timers busy, decode this edge directly
+        }
+#endif
+        doUpdate();
+    }
+
+    template <typename counter_t>
+    void Encoder_tpl<counter_t>::onSettled()
+    {
+        arm();      // re-arm before sampling, an edge during sampling starts a new blanking period
+        doUpdate(); // pin interrupts were masked, i.e. no concurrent decoding
     }
 
     template <typename counter_t>
@@ -65,6 +130,9 @@ namespace EncoderTool
     {
         iHelper::detachInterrupt(A.pin);
         iHelper::detachInterrupt(B.pin);
+#if defined(HAL_HAS_ONESHOT_TIMER)
+        tHelper::release(this);
+#endif
     }
 
     using Encoder = Encoder_tpl<int>;
@@ -2,14 +2,14 @@
 
 #include "../EncoderBase.h"
 #include "../HAL/directReadWrite.h"
+#include "../IdleMonitor.h"
 #include "Arduino.h"
-#include "Bounce2.h"
 
 namespace EncoderTool
 {
     // Simple encoder implementation which reads phase A and B from two digital pins
     template <typename counter_t>
-    class PolledEncoder_tpl : public EncoderBase<counter_t>
+    class PolledEncoder_tpl : public EncoderBase<counter_t>, public IdleMonitor
     {
      public:
         inline void begin(int pinA, int pinB, CountMode = CountMode::quarter, int inputMode = INPUT_PULLUP);
@@ -17,8 +17,11 @@ namespace EncoderTool
 
         inline void tick(); // call tick() as often as possible. For mechanical encoders a call frequency of > 5kHz should be sufficient
 
+        void setButtonDecimation(uint8_t n) { btnDecimation = n > 0 ? n : 1; } // read the button only every n-th tick
+
      protected:
-        bool hasButton = false;
+        bool hasButton        = false;
+        uint8_t btnDecimation = 1, btnCountdown = 0;
         HAL::pinRegInfo_t piA, piB, piBtn;
     };
 
@@ -29,11 +32,24 @@ namespace EncoderTool
     {
         using namespace HAL;
 
+        EncoderBase<counter_t>::decayVelocity(); // keeps decaying while idle
+        if (!idleScanDue()) return; // while idle only check for movement every wakeInterval
+
+        if (hasButton && btnCountdown-- == 0)
+        {
+            btnCountdown  = btnDecimation - 1;
+            bool btnState = EncoderBase<counter_t>::button.read();
+            EncoderBase<counter_t>::updateButton(directRead(piBtn));
+            if (EncoderBase<counter_t>::button.read() != btnState) activity();
+        }
+
         int A = directRead(piA);
         int B = directRead(piB);
-        int btn = hasButton ? directRead(piBtn) : LOW;
 
-        EncoderBase<counter_t>::update(A, B, btn);
+        uint8_t state = EncoderBase<counter_t>::curState;
+        EncoderBase<counter_t>::update(A, B);
+        if (EncoderBase<counter_t>::curState != state) activity(); // any edge counts as activity
+        checkIdle();
     }
 
     template <typename counter_t>
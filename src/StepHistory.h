@@ -0,0 +1,117 @@
+#pragma once
+
+#include "HAL/SimplyAtomic/SimplyAtomic.h"
+#include "TimeSource.h"
+#include <stdint.h>
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Steps of an encoder during a trailing time window
+     *
+     *  StepHistory<8> history(250);     // 250 ms window in 8 buckets
+     *  encoder.attachHistory(&history);
+     *  ...
+     *  int32_t moved = history.steps(); // steps in the last 250 ms (signed)
+     *  int32_t rate  = history.rate();  // steps per second
+     *
+     *  The steps are summed into time buckets of windowMs / bucketCount,
+     *  i.e. the memory doesn't depend on the spin speed. The window covers
+     *  the current (partial) bucket plus bucketCount - 1 full buckets.
+     *  A running total makes the queries O(1), buckets are expired on the
+     *  next step or query after their time is over.
+     ************************************************************************/
+    class StepHistoryBase
+    {
+     public:
+        inline void add(int_fast8_t steps); // called by EncoderBase::update()
+        inline int32_t steps();             // steps during the window
+        inline int32_t rate();              // steps per second during the window
+        inline void clear();
+
+        unsigned getWindow() const { return bucketMs * bucketCount; }
+
+     protected:
+        StepHistoryBase(int16_t* buckets, uint8_t bucketCount, unsigned windowMs)
+            : buckets(buckets), bucketCount(bucketCount), bucketMs(windowMs >= bucketCount ? windowMs / bucketCount : 1)
+        {
+            clear();
+        }
+
+        inline void expire(unsigned long now); // clears the buckets whose time is over
+
+        int16_t* const buckets;
+        const uint8_t bucketCount;
+        const unsigned bucketMs;
+
+        uint8_t head            = 0; // current bucket
+        unsigned long headStart = 0; // start time of the current bucket
+        int32_t total           = 0; // sum of all buckets
+    };
+
+    template <uint8_t nrOfBuckets>
+    class StepHistory : public StepHistoryBase
+    {
+        static_assert(nrOfBuckets > 0, "StepHistory needs at least one bucket");
+
+     public:
+        StepHistory(unsigned windowMs = 250) : StepHistoryBase(storage, nrOfBuckets, windowMs) {}
+
+     protected:
+        int16_t storage[nrOfBuckets];
+    };
+
+    // INLINE IMPLEMENTATION ==========================================================================
+
+    void StepHistoryBase::add(int_fast8_t steps)
+    {
+        expire(TimeSource::now());
+        if (buckets[head] + steps > INT16_MAX || buckets[head] + steps < INT16_MIN) return; // saturate
+        buckets[head] += steps;
+        total += steps;
+    }
+
+    int32_t StepHistoryBase::steps()
+    {
+        int32_t s;
+        ATOMIC()
+        {
+            expire(TimeSource::now());
+            s = total;
+        }
+        return s;
+    }
+
+    int32_t StepHistoryBase::rate()
+    {
+        return steps() * 1000 / (int32_t)getWindow();
+    }
+
+    void StepHistoryBase::clear()
+    {
+        ATOMIC()
+        {
+            for (uint8_t i = 0; i < bucketCount; i++) buckets[i] = 0;
+            head      = 0;
+            total     = 0;
+            headStart = TimeSource::now();
+        }
+    }
+
+    void StepHistoryBase::expire(unsigned long now)
+    {
+        unsigned long elapsed = now - headStart;
+        if (elapsed < bucketMs) return; // usual case, no division
+
+        unsigned long n = elapsed / bucketMs;
+        headStart += n * bucketMs;
+        if (n > bucketCount) n = bucketCount; // everything expired
+
+        while (n-- > 0)
+        {
+            if (++head == bucketCount) head = 0;
+            total -= buckets[head];
+            buckets[head] = 0;
+        }
+    }
+}
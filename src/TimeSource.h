@@ -0,0 +1,81 @@
+#pragma once
+
+#include "HAL/SimplyAtomic/SimplyAtomic.h"
+#include "config.h"
+#include <stdint.h>
+
+#if defined(ARDUINO)
+    #include "Arduino.h"
+#else
+    #include <chrono>
+#endif
+
+namespace EncoderTool
+{
+    /***********************************************************************
+     *  Time sources for the time dependent features (acceleration, button
+     *  debouncing, idle and fault detection, persistence). All of them
+     *  use the source selected by ENCODER_TIME_SOURCE in config.h.
+     *  now() returns milliseconds.
+     ************************************************************************/
+
+#if defined(ARDUINO)
+    struct MillisTime // default
+    {
+        static unsigned long now() { return millis(); }
+    };
+#else
+    struct SteadyClockTime // default for builds without Arduino
+    {
+        static unsigned long now()
+        {
+            using namespace std::chrono;
+            return (unsigned long)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+        }
+    };
+#endif
+
+    template <unsigned ticksPerMs>
+    struct TickCountTime // counts calls to advance(), e.g. from a fixed rate scan timer
+    {
+        static void advance() { ticks = ticks + 1; }
+        static unsigned long now()
+        {
+            if (sizeof(__SIG_ATOMIC_TYPE__) >= sizeof(unsigned long)) // compile time evaluation
+                return ticks / ticksPerMs;
+            else
+            {
+                ATOMIC() // advance() might run in an ISR, 32 bit reads aren't atomic on 8 bit processors
+                {
+                    return ticks / ticksPerMs;
+                }
+            }
+            return ticks / ticksPerMs; // make the compiler happy
+        }
+        static volatile unsigned long ticks;
+    };
+    template <unsigned ticksPerMs>
+    volatile unsigned long TickCountTime<ticksPerMs>::ticks = 0;
+
+    struct VirtualTime // set by the application, e.g. for deterministic host tests
+    {
+        static void set(unsigned long ms) { time() = ms; }
+        static void advance(unsigned long ms) { time() += ms; }
+        static unsigned long now() { return time(); }
+
+     protected:
+        static unsigned long& time()
+        {
+            static unsigned long t = 0; // function local, no definition in a translation unit needed
+            return t;
+        }
+    };
+
+#if defined(ENCODER_TIME_SOURCE)
+    using TimeSource = ENCODER_TIME_SOURCE;
+#elif defined(ARDUINO)
+    using TimeSource = MillisTime;
+#else
+    using TimeSource = SteadyClockTime;
+#endif
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+
+namespace EncoderTool
+{
+    // Overflow aware helpers for the counter types. The builtins are well defined for all integral types
+    // and wrap around (two's complement) on overflow. Fixed point types provide their own overloads.
+
+    template <typename T>
+    inline bool addOverflow(T a, T b, T* result) // returns true if the result wrapped around
+    {
+        return __builtin_add_overflow(a, b, result);
+    }
+
+    template <typename T>
+    inline T wrappingAdd(T a, T b)
+    {
+        T result;
+        __builtin_add_overflow(a, b, &result);
+        return result;
+    }
+
+    template <typename T>
+    inline T wrappingSub(T a, T b)
+    {
+        T result;
+        __builtin_sub_overflow(a, b, &result);
+        return result;
+    }
+
+    template <typename T>
+    inline bool subOverflow(T a, T b, T* result)
+    {
+        return __builtin_sub_overflow(a, b, result);
+    }
+
+    template <typename T>
+    inline T maskBits(T a, T mask)
+    {
+        return a & mask;
+    }
+
+    template <typename T>
+    inline T lsb(T) // smallest representable step
+    {
+        return 1;
+    }
+
+    template <typename T>
+    inline T fromQ8(int32_t q8, T) // fixed point value (1/256) to T, rounds towards zero and saturates
+    {
+        int32_t v = q8 / 256;
+        if (sizeof(T) < sizeof(int32_t)) // compile time evaluation
+        {
+            if (v > (int32_t)std::numeric_limits<T>::max()) return std::numeric_limits<T>::max();
+            if (v < (int32_t)std::numeric_limits<T>::min()) return std::numeric_limits<T>::min();
+        }
+        return (T)v;
+    }
+}
@@ -3,6 +3,10 @@
 // comment the following line out if you prefer plain vanilla function pointers for callbacks
 #define WANT_MODERN_CALLBACKS
 
+// time source for acceleration, debouncing, idle/fault detection and persistence (see TimeSource.h), default: MillisTime
+// default without Arduino (host builds): SteadyClockTime
+// #define ENCODER_TIME_SOURCE EncoderTool::VirtualTime
+
 //================================================================================================================
 
 #if defined(__AVR__)
@@ -17,6 +21,7 @@
 
 #else
     #include <limits>
+    #include <stddef.h>
     #include <type_traits>
     using std::is_integral;
     using std::is_signed;
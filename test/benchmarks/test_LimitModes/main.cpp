@@ -0,0 +1,76 @@
+#include "EncoderBase.h"
+#include <chrono>
+#include <stdio.h>
+#include <unity.h>
+
+using namespace EncoderTool;
+
+// step() only, i.e. the cost of the limit handling without the decoder
+class StepBench : public EncoderBase<int>
+{
+ public:
+    __attribute__((noinline)) long run(long n)
+    {
+        long sum = 0;
+        for (long i = 0; i < n; i++) sum += step((i & 15) == 0 ? -1 : 1); // mostly forward, some reversals
+        return sum;
+    }
+};
+
+void stepCost()
+{
+    struct
+    {
+        const char* name;
+        int min, max;
+        bool periodic;
+        int start;
+        double best;
+    } cfg[] = {
+        {"unbounded", 1, -1, false, 0, 1e9},
+        {"clamped", -2000000000, 2000000000, false, 0, 1e9},
+        {"clamped, at limit", -100, 100, false, 100, 1e9},
+        {"periodic 0..99", 0, 99, true, 0, 1e9},
+        {"periodicPow2 0..127", 0, 127, true, 0, 1e9},
+    };
+
+    constexpr long N = 20000000;
+    StepBench enc;
+    for (int r = 0; r < 10; r++) // best of 10 interleaved runs, the host isn't quiet
+    {
+        for (auto& c : cfg)
+        {
+            enc.setLimits(1, -1);
+            enc.setValue(c.start);
+            enc.setLimits(c.min, c.max, c.periodic);
+            auto t0  = std::chrono::steady_clock::now();
+            long sum = enc.run(N);
+            auto t1  = std::chrono::steady_clock::now();
+            TEST_ASSERT_TRUE(sum != 0x7FFFFFFF); // keeps the loop
+            double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / N;
+            if (ns < c.best) c.best = ns;
+        }
+    }
+
+    char msg[80];
+    for (auto& c : cfg)
+    {
+        snprintf(msg, sizeof(msg), "%-20s %.2f ns/step", c.name, c.best);
+        TEST_MESSAGE(msg);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(stepCost);
+    return UNITY_END();
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
@@ -0,0 +1,107 @@
+#include "Multiplexed/PolledEncoderArray.h"
+#include <chrono>
+#include <stdio.h>
+#include <unity.h>
+
+using namespace EncoderTool;
+using HAL::HostBoard;
+
+// The previous tick(): every channel with a button is processed on each button scan
+class DispatchAll : public PolledEncoderArray<8>
+{
+ public:
+    void tick()
+    {
+        if (!idleScanDue()) return;
+
+        port_t changed[16];
+        for (uint8_t g = 0; g < groupCount; g++)
+        {
+            port_t snapshot = readGroup(g);
+            changed[g]      = snapshot ^ groups[g].last;
+            groups[g].last  = snapshot;
+        }
+        bool scanButtons = buttonScanDue();
+
+        for (unsigned ch = 0; ch < 8; ch++)
+        {
+            const channel_t& c = channels[ch];
+            uint8_t a          = (groups[c.groupA].last & c.maskA) != 0;
+            uint8_t b          = (groups[c.groupB].last & c.maskB) != 0;
+            if (scanButtons)
+                process(ch, a, b, HAL::directRead(c.btn));
+            else if ((changed[c.groupA] & c.maskA) | (changed[c.groupB] & c.maskB))
+                process(ch, a, b);
+        }
+        checkIdle();
+        checkFaults();
+    }
+};
+
+template <typename T>
+__attribute__((noinline)) double nsPerTick(T& encoders)
+{
+    static const uint8_t seqA[] = {1, 1, 0, 0}, seqB[] = {1, 0, 0, 1};
+    constexpr long N = 2000000;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (long k = 0; k < N; k++)
+    {
+        if ((k & 63) == 0) // channel 0 moves every 64 ticks
+        {
+            HostBoard::setPin(0, seqA[(k >> 6) & 3]);
+            HostBoard::setPin(1, seqB[(k >> 6) & 3]);
+        }
+        if ((k & 0xFFFF) == 0) HostBoard::setPin(16, (k >> 16) & 1); // button 0 changes now and then
+        encoders.tick();
+        if ((k & 127) == 0) VirtualTime::advance(1);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / N;
+}
+
+template <typename T>
+void setup(T& encoders)
+{
+    for (unsigned ch = 0; ch < 8; ch++) encoders.setPins(ch, 2 * ch, 2 * ch + 1, 16 + ch); // buttons on the same port
+    encoders.begin();
+    encoders.setButtonDecimation(1);
+}
+
+void buttonsAtFullRate()
+{
+    for (uint8_t pin = 0; pin < 24; pin++) HostBoard::setPin(pin, 1);
+
+    PolledEncoderArray<8> compare;
+    DispatchAll all;
+    setup(compare);
+    setup(all);
+
+    double bestCompare = 1e9, bestAll = 1e9;
+    for (int r = 0; r < 7; r++) // best of 7 interleaved runs, the host isn't quiet
+    {
+        double c = nsPerTick(compare), a = nsPerTick(all);
+        if (c < bestCompare) bestCompare = c;
+        if (a < bestAll) bestAll = a;
+    }
+    TEST_ASSERT_EQUAL_INT(all[0].getValue(), compare[0].getValue()); // same work
+    TEST_ASSERT_EQUAL_INT(all[0].getButton(), compare[0].getButton());
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "8 channels with buttons: compare %.1f ns/tick, dispatch all %.1f ns/tick", bestCompare, bestAll);
+    TEST_MESSAGE(msg);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(buttonsAtFullRate);
+    return UNITY_END();
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
@@ -0,0 +1,85 @@
+#include "Analog/SinCosEncoder.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <unity.h>
+
+using namespace EncoderTool;
+
+constexpr size_t pairs = 4096;
+static uint16_t samples[2 * pairs]; // interleaved sin, cos as delivered by an ADC DMA channel
+
+__attribute__((noinline)) double processRate(SinCosEncoder& enc, int rounds)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) enc.process(samples, pairs);
+    return rounds * pairs / std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+__attribute__((noinline)) double atan2Rate(uint32_t& sum, int rounds) // CORDIC only, without the encoder
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+        for (size_t i = 0; i < pairs; i++) sum += SinCosEncoder::atan2Turns(samples[2 * i] - 2048, samples[2 * i + 1] - 2048);
+    return rounds * pairs / std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+__attribute__((noinline)) double floatRate(float& counts, int rounds) // the same unwrapping with atan2f
+{
+    float last = 0;
+    auto t0    = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+        for (size_t i = 0; i < pairs; i++)
+        {
+            float a = atan2f(samples[2 * i] - 2048.0f, samples[2 * i + 1] - 2048.0f);
+            float d = a - last;
+            last    = a;
+            if (d > (float)M_PI) d -= 2 * (float)M_PI;
+            if (d < -(float)M_PI) d += 2 * (float)M_PI;
+            counts += d * 256 / (2 * (float)M_PI);
+        }
+    return rounds * pairs / std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void samplesPerSecond()
+{
+    for (size_t i = 0; i < pairs; i++)
+    {
+        samples[2 * i]     = 2048 + lround(1500 * sin(i * 0.01));
+        samples[2 * i + 1] = 2048 + lround(1500 * cos(i * 0.01));
+    }
+
+    SinCosEncoder enc;
+    enc.begin(samples[0], samples[1], 256);
+    float counts = 0;
+    uint32_t sum = 0;
+
+    double bestEnc = 0, bestCordic = 0, bestFloat = 0;
+    for (int r = 0; r < 7; r++) // best of 7 interleaved runs, the host isn't quiet
+    {
+        double e = processRate(enc, 200), c = atan2Rate(sum, 200), f = floatRate(counts, 200);
+        if (e > bestEnc) bestEnc = e;
+        if (c > bestCordic) bestCordic = c;
+        if (f > bestFloat) bestFloat = f;
+    }
+    TEST_ASSERT_TRUE(enc.getValue() != 0 && sum != 0 && counts != 0); // all did the work
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "M sample pairs/s: process() %.1f, atan2Turns() %.1f, atan2f loop %.1f", bestEnc / 1e6, bestCordic / 1e6, bestFloat / 1e6);
+    TEST_MESSAGE(msg);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(samplesPerSecond);
+    return UNITY_END();
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
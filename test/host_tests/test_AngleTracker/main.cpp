@@ -0,0 +1,77 @@
+#include "EncoderBase.h"
+#include <unity.h>
+
+using namespace EncoderTool;
+
+class Feeder : public EncoderBase<int> // feeds counts like the interpolating front ends
+{
+ public:
+    using EncoderBase<int>::reportCounts;
+};
+
+void anglesAndRevolutions()
+{
+    static uint16_t cbAngle;
+    static int32_t cbRevs;
+
+    AngleTracker tracker(400);
+    Feeder enc;
+    enc.setLimits(0, 10); // the angle is independent of the value
+    enc.attachAngleTracker(&tracker);
+    tracker.attachCallback([](uint16_t angle, int32_t revolutions) {
+        cbAngle = angle;
+        cbRevs  = revolutions;
+    });
+
+    enc.reportCounts(100);
+    TEST_ASSERT_EQUAL_UINT16(16384, tracker.getAngle()); // 90°
+    TEST_ASSERT_EQUAL_INT32(0, tracker.getRevolutions());
+
+    enc.reportCounts(350);
+    TEST_ASSERT_EQUAL_INT32(1, tracker.getRevolutions());
+    TEST_ASSERT_EQUAL_UINT16(8192, tracker.getAngle());
+    TEST_ASSERT_EQUAL_UINT16(8192, cbAngle);
+    TEST_ASSERT_EQUAL_INT32(1, cbRevs);
+
+    enc.reportCounts(-500);
+    TEST_ASSERT_EQUAL_INT32(-1, tracker.getRevolutions());
+    TEST_ASSERT_EQUAL_UINT16(57344, tracker.getAngle()); // 350/400 turn
+    TEST_ASSERT_EQUAL_INT(0, enc.getValue());
+
+    tracker.reset();
+    TEST_ASSERT_EQUAL_UINT16(0, tracker.getAngle());
+    TEST_ASSERT_EQUAL_INT32(0, tracker.getRevolutions());
+}
+
+void detachedTrackerStops()
+{
+    AngleTracker tracker(3); // angles of odd counts per revolution are rounded
+    Feeder enc;
+    enc.attachAngleTracker(&tracker);
+    enc.reportCounts(1);
+    TEST_ASSERT_EQUAL_UINT16(21845, tracker.getAngle());
+    enc.reportCounts(2);
+    TEST_ASSERT_EQUAL_INT32(1, tracker.getRevolutions());
+    TEST_ASSERT_EQUAL_UINT16(0, tracker.getAngle());
+
+    enc.attachAngleTracker(nullptr);
+    enc.reportCounts(5);
+    TEST_ASSERT_EQUAL_INT32(1, tracker.getRevolutions());
+    TEST_ASSERT_EQUAL_INT(8, enc.getValue());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(anglesAndRevolutions);
+    RUN_TEST(detachedTrackerStops);
+    return UNITY_END();
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
@@ -0,0 +1,113 @@
+#include "Single/Encoder.h"
+#include <stdlib.h>
+#include <unity.h>
+
+using namespace EncoderTool;
+using HAL::HostBoard;
+
+// Bounce generator: 'steps' quarter steps on pins 2/3, each edge followed by 0..6 bounces of 20..50 µs, 2 ms per step.
+// Turns forward for the first half and backward for the second half. Returns the number of pin interrupts.
+static unsigned long turn(Encoder& enc, unsigned blanking, int steps)
+{
+    static const uint8_t seqA[] = {1, 0, 0, 1}, seqB[] = {1, 1, 0, 0};
+
+    HostBoard::setPin(2, 1);
+    HostBoard::setPin(3, 1);
+    enc.begin(2, 3, CountMode::quarter);
+    TEST_ASSERT_TRUE(enc.setBlanking(blanking));
+    HostBoard::pinInterrupts() = 0;
+
+    srand(1);
+    int idx = 0;
+    for (int step = 0; step < steps; step++)
+    {
+        int next    = (idx + (step < steps / 2 ? 1 : 3)) & 3;
+        uint8_t pin = seqA[next] != seqA[idx] ? 2 : 3;
+        uint8_t val = pin == 2 ? seqA[next] : seqB[next];
+
+        int bounces = rand() % 7;
+        for (int b = 0; b < bounces; b++)
+        {
+            HostBoard::setPin(pin, b % 2 ? !val : val);
+            HostBoard::advance(20 + rand() % 30);
+        }
+        HostBoard::setPin(pin, val);
+        HostBoard::advance(2000);
+        idx = next;
+    }
+    return HostBoard::pinInterrupts();
+}
+
+void blankingSavesInterrupts()
+{
+    unsigned long plainIsrs, blankedIsrs;
+    int plainValue, blankedValue;
+    {
+        Encoder enc; // the destructor frees the pins for the second run
+        plainIsrs  = turn(enc, 0, 4000);
+        plainValue = enc.getValue();
+    }
+    {
+        Encoder enc;
+        blankedIsrs  = turn(enc, 400, 4000);
+        blankedValue = enc.getValue();
+    }
+
+    char msg[80];
+    snprintf(msg, sizeof(msg), "pin interrupts: %lu without, %lu with blanking", plainIsrs, blankedIsrs);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL_INT(plainValue, blankedValue);
+    TEST_ASSERT_EQUAL_INT(0, blankedValue);     // 2000 quarter steps forward and back
+    TEST_ASSERT_EQUAL_UINT32(4000, blankedIsrs);  // one per settled edge
+    TEST_ASSERT_GREATER_THAN(3 * blankedIsrs, plainIsrs);
+}
+
+void rearmsWithoutLoop()
+{
+    Encoder enc;
+    turn(enc, 400, 8); // 4 forward, 4 back, nothing but the simulated time drives the encoder
+    TEST_ASSERT_EQUAL_INT(0, enc.getValue());
+
+    HostBoard::setPin(3, 0); // one detent, the edges after the last blanking period are decoded again
+    HostBoard::advance(500);
+    HostBoard::setPin(2, 0);
+    HostBoard::advance(500);
+    HostBoard::setPin(3, 1);
+    HostBoard::advance(500);
+    HostBoard::setPin(2, 1);
+    HostBoard::advance(500);
+    TEST_ASSERT_EQUAL_INT(1, enc.getValue());
+}
+
+void noTimerLeft()
+{
+    Encoder enc[IntervalTimer::maxTimers + 1];
+    for (unsigned i = 0; i < IntervalTimer::maxTimers; i++)
+    {
+        enc[i].begin(2 * i + 4, 2 * i + 5);
+        TEST_ASSERT_TRUE(enc[i].setBlanking(100));
+    }
+    enc[IntervalTimer::maxTimers].begin(20, 21);
+    TEST_ASSERT_FALSE(enc[IntervalTimer::maxTimers].setBlanking(100)); // decodes every edge instead
+
+    enc[0].setBlanking(0); // frees the timer
+    TEST_ASSERT_TRUE(enc[IntervalTimer::maxTimers].setBlanking(100));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(blankingSavesInterrupts);
+    RUN_TEST(rearmsWithoutLoop);
+    RUN_TEST(noTimerLeft);
+    return UNITY_END();
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
@@ -0,0 +1,149 @@
+#include "Multiplexed/EncPlexBase.h"
+#include <unity.h>
+
+using namespace EncoderTool;
+
+// Multiplexer reading its channels from memory, one tick per ms
+class SimPlex : public EncPlexBase<int>
+{
+ public:
+    SimPlex(unsigned n) : EncPlexBase<int>(n), inputs(new uint8_t[n]) {}
+    ~SimPlex() { delete[] inputs; }
+
+    void begin(CountMode mode = CountMode::quarter)
+    {
+        EncPlexBase<int>::begin(mode);
+        for (unsigned ch = 0; ch < encoderCount; ch++)
+        {
+            inputs[ch] = 0b11; // detent of CountMode::quarter
+            encoders[ch].begin(1, 1);
+        }
+    }
+
+    void tick()
+    {
+        for (unsigned ch = 0; ch < encoderCount; ch++) process(ch, inputs[ch] >> 1, inputs[ch] & 1);
+        checkFaults();
+    }
+
+    void turn(unsigned ch, int n) // n transitions (gray code)
+    {
+        static const uint8_t next[] = {0b01, 0b11, 0b00, 0b10};
+        static const uint8_t prev[] = {0b10, 0b00, 0b11, 0b01};
+        for (; n > 0; n--) { inputs[ch] = next[inputs[ch]]; run(1); }
+        for (; n < 0; n++) { inputs[ch] = prev[inputs[ch]]; run(1); }
+    }
+
+    void run(unsigned ms)
+    {
+        for (unsigned i = 0; i < ms; i++)
+        {
+            tick();
+            VirtualTime::advance(1);
+        }
+    }
+
+    uint8_t* inputs;
+};
+
+static int faults, recoveries;
+
+static void countFaults(uint_fast8_t ch, bool faulted)
+{
+    faulted ? faults++ : recoveries++;
+}
+
+void stuckBetweenDetentsLatches()
+{
+    SimPlex plex(2);
+    plex.begin();
+    plex.setFaultDetection(5, 100, 1000);
+    plex.attachFaultCallback(countFaults);
+
+    plex.turn(1, 1); // stays between two detents (e.g. a broken line)
+    plex.run(1000);
+    TEST_ASSERT_TRUE(plex.isFaulted(1));
+    TEST_ASSERT_FALSE(plex.isFaulted(0));
+
+    plex.run(10000); // stable between the detents: no recovery
+    TEST_ASSERT_TRUE(plex.isFaulted(1));
+    TEST_ASSERT_EQUAL_INT(1, faults);
+    TEST_ASSERT_EQUAL_INT(0, recoveries);
+}
+
+void recoversAtDetent()
+{
+    SimPlex plex(1);
+    plex.begin();
+    plex.setFaultDetection(5, 100, 1000);
+    plex.attachFaultCallback(countFaults);
+
+    plex.turn(0, 1);
+    plex.run(2000);
+    TEST_ASSERT_TRUE(plex.isFaulted(0));
+
+    plex.turn(0, -1); // back to the detent
+    plex.run(999);
+    TEST_ASSERT_TRUE(plex.isFaulted(0)); // needs to be stable for stuckTimeout
+    plex.run(2);
+    TEST_ASSERT_FALSE(plex.isFaulted(0));
+    TEST_ASSERT_EQUAL_INT(1, recoveries);
+
+    plex.turn(0, 4); // decodes again
+    TEST_ASSERT_EQUAL_INT(1, plex[0].getValue());
+}
+
+void recoversAfterValidTransitions()
+{
+    SimPlex plex(1);
+    plex.begin();
+    plex.setFaultDetection(2, 100, 1000);
+    plex.attachFaultCallback(countFaults);
+
+    for (int i = 0; i < 20; i++) // invalid transitions (both lines at once)
+    {
+        plex.inputs[0] ^= 0b11;
+        plex.run(1);
+    }
+    plex.run(100);
+    TEST_ASSERT_TRUE(plex.isFaulted(0));
+
+    plex.turn(0, 7);
+    TEST_ASSERT_TRUE(plex.isFaulted(0));
+    plex.turn(0, 1);
+    plex.run(1);
+    TEST_ASSERT_FALSE(plex.isFaulted(0)); // recovered while moving
+    TEST_ASSERT_EQUAL_INT(0, plex[0].getValue()); // nothing counted while quarantined
+}
+
+void noStuckDetectionInFullMode()
+{
+    SimPlex plex(1);
+    plex.begin(CountMode::full); // every state is a detent
+    plex.setFaultDetection(5, 100, 1000);
+
+    plex.turn(0, 1);
+    plex.run(5000);
+    TEST_ASSERT_FALSE(plex.isFaulted(0));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(stuckBetweenDetentsLatches);
+    RUN_TEST(recoversAtDetent);
+    RUN_TEST(recoversAfterValidTransitions);
+    RUN_TEST(noStuckDetectionInFullMode);
+    return UNITY_END();
+}
+
+void setUp()
+{
+    VirtualTime::set(0);
+    faults     = 0;
+    recoveries = 0;
+}
+
+void tearDown()
+{
+}
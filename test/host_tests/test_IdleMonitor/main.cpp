@@ -0,0 +1,163 @@
+#include "Multiplexed/EncPlexBase.h"
+#include <stdio.h>
+#include <unity.h>
+
+using namespace EncoderTool;
+
+// Multiplexer reading its channels from memory, counts ticks and actual scans
+class SimPlex : public EncPlexBase<int>
+{
+ public:
+    SimPlex(unsigned n) : EncPlexBase<int>(n), inputs(new uint8_t[n]()) {}
+    ~SimPlex() { delete[] inputs; }
+
+    void begin() { EncPlexBase<int>::begin(CountMode::full); }
+
+    void tick()
+    {
+        ticks++;
+        if (!idleScanDue()) return;
+
+        scans++;
+        for (unsigned ch = 0; ch < encoderCount; ch++) process(ch, inputs[ch] >> 1, inputs[ch] & 1);
+        checkIdle();
+    }
+
+    void turn(unsigned ch) // one count forward (gray code)
+    {
+        static const uint8_t next[] = {0b01, 0b11, 0b00, 0b10};
+        inputs[ch] = next[inputs[ch]];
+    }
+
+    uint8_t* inputs;
+    unsigned long ticks = 0, scans = 0;
+};
+
+static void run(SimPlex& plex, unsigned ms, unsigned ticksPerMs = 10)
+{
+    for (unsigned i = 0; i < ms; i++)
+    {
+        for (unsigned t = 0; t < ticksPerMs; t++) plex.tick();
+        VirtualTime::advance(1);
+    }
+}
+
+void goesIdleAfterTimeout()
+{
+    SimPlex plex(4);
+    plex.begin();
+    plex.setIdleTimeout(100, 50);
+
+    static int idleEvents;
+    idleEvents = 0;
+    plex.attachIdleCallback([](bool idle) { idleEvents += idle ? 1 : -1; });
+
+    run(plex, 99);
+    TEST_ASSERT_FALSE(plex.isIdle());
+    run(plex, 2);
+    TEST_ASSERT_TRUE(plex.isIdle());
+    TEST_ASSERT_EQUAL_INT(1, idleEvents);
+}
+
+void wakesOnMovement()
+{
+    SimPlex plex(4);
+    plex.begin();
+    plex.setIdleTimeout(100, 50);
+    run(plex, 200);
+    TEST_ASSERT_TRUE(plex.isIdle());
+
+    plex.turn(2);
+    run(plex, 50); // seen by the next wake check at the latest
+    TEST_ASSERT_FALSE(plex.isIdle());
+    TEST_ASSERT_EQUAL_INT(1, plex[2].getValue());
+}
+
+void groupIdleWhenAllMembersIdle()
+{
+    SimPlex a(2), b(2);
+    a.begin();
+    b.begin();
+    a.setIdleTimeout(100, 50);
+    b.setIdleTimeout(300, 50);
+
+    IdleGroup group;
+    group.add(a);
+    group.add(b);
+
+    static int groupEvents;
+    groupEvents = 0;
+    group.attachIdleCallback([](bool idle) { groupEvents += idle ? 1 : -1; });
+
+    for (unsigned ms = 0; ms < 200; ms++)
+    {
+        a.tick();
+        b.tick();
+        VirtualTime::advance(1);
+    }
+    TEST_ASSERT_TRUE(a.isIdle());
+    TEST_ASSERT_FALSE(group.isIdle());
+
+    for (unsigned ms = 0; ms < 200; ms++)
+    {
+        a.tick();
+        b.tick();
+        VirtualTime::advance(1);
+    }
+    TEST_ASSERT_TRUE(group.isIdle());
+    TEST_ASSERT_EQUAL_INT(1, groupEvents);
+
+    b.turn(0);
+    for (unsigned ms = 0; ms < 60; ms++)
+    {
+        a.tick();
+        b.tick();
+        VirtualTime::advance(1);
+    }
+    TEST_ASSERT_FALSE(group.isIdle());
+    TEST_ASSERT_EQUAL_INT(0, groupEvents);
+}
+
+// Scan duty cycle of a 16 channel plexer ticked at 10 kHz over one minute:
+// turned for 2 s, then untouched. Idle after 1 s, wake check every 50 ms.
+void scanDutyCycle()
+{
+    SimPlex plex(16);
+    plex.begin();
+    plex.setIdleTimeout(1000, 50);
+
+    for (unsigned ms = 0; ms < 60000; ms++)
+    {
+        if (ms < 2000 && ms % 10 == 0) plex.turn(ms / 10 % 16);
+        for (unsigned t = 0; t < 10; t++) plex.tick();
+        VirtualTime::advance(1);
+    }
+
+    char msg[100];
+    snprintf(msg, sizeof(msg), "scans: %lu of %lu ticks, duty cycle %.2f%%", plex.scans, plex.ticks, 100.0 * plex.scans / plex.ticks);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL_UINT32(600000, plex.ticks);
+    TEST_ASSERT_EQUAL_UINT32(29901 + 1140, plex.scans); // full rate until 1 s after the last turn, then 20 wake checks per second
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(goesIdleAfterTimeout);
+    RUN_TEST(wakesOnMovement);
+    RUN_TEST(groupIdleWhenAllMembersIdle);
+    RUN_TEST(scanDutyCycle);
+
+    return UNITY_END();
+}
+
+void setUp(void)
+{
+    VirtualTime::set(0);
+}
+
+void tearDown(void)
+{
+}
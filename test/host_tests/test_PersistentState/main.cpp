@@ -0,0 +1,158 @@
+#include "Persistence/FileStorage.h"
+#include "Persistence/PersistentState.h"
+#include <stdio.h>
+#include <unity.h>
+
+using namespace EncoderTool;
+
+class Plex : public EncPlexBase<int> // values only, nothing to scan
+{
+ public:
+    Plex(unsigned n) : EncPlexBase<int>(n) {}
+};
+
+static const char* fileName = "test_persistent_state.bin";
+
+static void idle(PersistentState<FileStorage>& state, unsigned ms)
+{
+    for (unsigned i = 0; i < ms; i++)
+    {
+        state.tick();
+        VirtualTime::advance(1);
+    }
+}
+
+void restoresNewestRecord()
+{
+    {
+        Plex plex(4);
+        FileStorage storage(fileName, 256);
+        PersistentState<FileStorage> state(plex, storage, 100);
+
+        for (int round = 1; round <= 10; round++) // more records than slots
+        {
+            for (unsigned ch = 0; ch < 4; ch++) plex[ch].setValue(round * 10 + ch);
+            idle(state, 200);
+        }
+        TEST_ASSERT_FALSE(state.isWriting());
+        TEST_ASSERT_EQUAL_UINT32(10, storage.commits); // one commit per record
+    }
+
+    Plex plex(4);
+    FileStorage storage(fileName, 256);
+    PersistentState<FileStorage> state(plex, storage);
+    TEST_ASSERT_TRUE(state.restore());
+    for (unsigned ch = 0; ch < 4; ch++) TEST_ASSERT_EQUAL_INT(100 + ch, plex[ch].getValue());
+}
+
+void coalescesChanges()
+{
+    Plex plex(4);
+    FileStorage storage(fileName, 256);
+    PersistentState<FileStorage> state(plex, storage, 100);
+
+    for (int v = 1; v <= 50; v++) // a change every 10 ms, i.e. never idle for 100 ms
+    {
+        plex[1].setValue(v);
+        idle(state, 10);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, storage.bytesWritten);
+
+    idle(state, 200);
+    TEST_ASSERT_EQUAL_UINT32(1, storage.commits);
+    TEST_ASSERT_EQUAL_UINT32(4 + 4 * sizeof(int) + 2, storage.bytesWritten);
+}
+
+void survivesTornSlot0()
+{
+    {
+        Plex plex(2);
+        FileStorage storage(fileName, 120);
+        PersistentState<FileStorage> state(plex, storage, 100);
+        TEST_ASSERT_EQUAL_UINT32(8, state.getSlotCount());
+
+        for (int round = 1; round <= 9; round++) // 9th record overwrites slot 0
+        {
+            plex[0].setValue(round);
+            idle(state, 200);
+        }
+        uint8_t garbage[4] = {0x12, 0x34, 0x56, 0x78};
+        storage.write(2, garbage, sizeof(garbage)); // power loss while rewriting slot 0
+    }
+
+    Plex plex(2);
+    FileStorage storage(fileName, 120);
+    PersistentState<FileStorage> state(plex, storage);
+    TEST_ASSERT_TRUE(state.restore());
+    TEST_ASSERT_EQUAL_INT(8, plex[0].getValue()); // newest intact record
+}
+
+// 16 channels, 200 sessions of 50 changes (one per 20 ms) with a pause of 5 s in between
+// storage: 4 kB, records are written after 2 s without changes
+void writeAmplificationAndBootScan()
+{
+    const unsigned channels = 16, sessions = 200, changesPerSession = 50;
+    unsigned long changes = 0;
+    unsigned slotCount;
+    {
+        Plex plex(channels);
+        FileStorage storage(fileName, 4096);
+        PersistentState<FileStorage> state(plex, storage);
+        slotCount = state.getSlotCount();
+
+        for (unsigned s = 0; s < sessions; s++)
+        {
+            for (unsigned c = 0; c < changesPerSession; c++)
+            {
+                unsigned ch = (s + c / 10) % channels;
+                plex[ch].setValue(plex[ch].getValue() + 1);
+                changes++;
+                idle(state, 20);
+            }
+            idle(state, 5000);
+        }
+
+        unsigned long naiveBytes = changes * sizeof(int); // every change written to its own cell
+        char msg[160];
+        snprintf(msg, sizeof(msg), "%lu changes -> %lu records, %lu bytes written (naive: %lu), max cell wear %u (naive: >= %lu)",
+                 changes, storage.commits, storage.bytesWritten, naiveBytes, (unsigned)storage.getMaxWear(), changes / channels);
+        TEST_MESSAGE(msg);
+
+        TEST_ASSERT_EQUAL_UINT32(sessions, storage.commits);                  // one record per session
+        TEST_ASSERT_EQUAL_UINT32(sessions * (4 + channels * sizeof(int) + 2), storage.bytesWritten);
+        TEST_ASSERT_EQUAL_UINT32((sessions + slotCount - 1) / slotCount, storage.getMaxWear()); // spread over all slots
+    }
+
+    Plex plex(channels);
+    FileStorage storage(fileName, 4096);
+    PersistentState<FileStorage> state(plex, storage);
+    TEST_ASSERT_TRUE(state.restore());
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "boot: %lu slot reads (%lu bytes) for %u slots", storage.readCalls, storage.bytesRead, slotCount);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_LESS_OR_EQUAL(2 + 6, storage.readCalls); // slot 0, binary search over 58 slots, final read
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(restoresNewestRecord);
+    RUN_TEST(coalescesChanges);
+    RUN_TEST(survivesTornSlot0);
+    RUN_TEST(writeAmplificationAndBootScan);
+
+    return UNITY_END();
+}
+
+void setUp(void)
+{
+    VirtualTime::set(0);
+    remove(fileName);
+}
+
+void tearDown(void)
+{
+    remove(fileName);
+}
@@ -0,0 +1,65 @@
+#include "Sampling/PinSource.h"
+#include <unity.h>
+
+using namespace EncoderTool;
+using HAL::HostBoard;
+
+using PinEncoder = SourcedEncoder_tpl<int, PinSource>;
+
+static void run(PinEncoder& enc, unsigned ms)
+{
+    for (unsigned i = 0; i < ms; i++)
+    {
+        enc.tick();
+        VirtualTime::advance(1);
+    }
+}
+
+void noButtonNoEvents()
+{
+    PinSource pins(2, 3); // pull ups, A = B = HIGH
+    PinEncoder enc(pins);
+    TEST_ASSERT_TRUE(enc.begin(CountMode::quarter));
+
+    static int events;
+    events = 0;
+    enc.attachButtonCallback([](int_fast8_t) { events++; });
+
+    run(enc, 100); // well beyond the debounce interval
+    TEST_ASSERT_FALSE(enc.buttonChanged());
+    TEST_ASSERT_EQUAL_INT(0, events);
+    TEST_ASSERT_EQUAL_INT(0, enc.getButton());
+}
+
+void buttonIsDebounced()
+{
+    PinSource pins(4, 5, 6);
+    PinEncoder enc(pins);
+    enc.begin(CountMode::quarter);
+    run(enc, 100);
+    enc.buttonChanged(); // pull up: released button reads HIGH
+
+    HostBoard::setPin(6, 0);
+    run(enc, 5);
+    TEST_ASSERT_FALSE(enc.buttonChanged());
+    run(enc, 10);
+    TEST_ASSERT_TRUE(enc.buttonChanged());
+    TEST_ASSERT_EQUAL_INT(0, enc.getButton());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(noButtonNoEvents);
+    RUN_TEST(buttonIsDebounced);
+    return UNITY_END();
+}
+
+void setUp()
+{
+    VirtualTime::set(0);
+}
+
+void tearDown()
+{
+}
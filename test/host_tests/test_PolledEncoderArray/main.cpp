@@ -0,0 +1,68 @@
+#include "Multiplexed/PolledEncoderArray.h"
+#include <unity.h>
+
+using namespace EncoderTool;
+using HAL::HostBoard;
+
+static PolledEncoderArray<4> encoders;
+
+static void run(unsigned ms) // 10 ticks per ms
+{
+    for (unsigned i = 0; i < 10 * ms; i++)
+    {
+        encoders.tick();
+        if (i % 10 == 9) VirtualTime::advance(1);
+    }
+}
+
+void setUp()
+{
+    VirtualTime::set(0);
+    for (uint8_t pin = 0; pin < 16; pin++) HostBoard::setPin(pin, 1);
+}
+
+void tearDown()
+{
+}
+
+void buttonsAreDebounced()
+{
+    static int events[4];
+    for (unsigned ch = 0; ch < 4; ch++)
+    {
+        events[ch] = 0;
+        TEST_ASSERT_TRUE(encoders.setPins(ch, 2 * ch, 2 * ch + 1, 8 + ch));
+    }
+    encoders.begin();
+    encoders[0].attachButtonCallback([](int_fast8_t) { events[0]++; });
+    encoders[2].attachButtonCallback([](int_fast8_t) { events[2]++; });
+
+    run(50); // settles on the released (HIGH) state
+    for (unsigned ch = 0; ch < 4; ch++) TEST_ASSERT_EQUAL_INT(1, encoders[ch].getButton());
+    events[0] = events[2] = 0;
+
+    HostBoard::setPin(10, 0); // press button 2, bounce once within the debounce interval
+    run(3);
+    HostBoard::setPin(10, 1);
+    run(1);
+    HostBoard::setPin(10, 0);
+    run(5);
+    TEST_ASSERT_EQUAL_INT(1, encoders[2].getButton()); // still bouncing
+    run(10);
+    TEST_ASSERT_EQUAL_INT(0, encoders[2].getButton());
+    TEST_ASSERT_EQUAL_INT(1, events[2]);
+    TEST_ASSERT_EQUAL_INT(0, events[0]);
+
+    HostBoard::setPin(10, 1); // release
+    run(20);
+    TEST_ASSERT_EQUAL_INT(1, encoders[2].getButton());
+    TEST_ASSERT_EQUAL_INT(2, events[2]);
+    for (unsigned ch : {0u, 1u, 3u}) TEST_ASSERT_EQUAL_INT(1, encoders[ch].getButton());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(buttonsAreDebounced);
+    return UNITY_END();
+}
@@ -0,0 +1,106 @@
+#include "Sampling/PortSampler.h"
+#include <stdlib.h>
+#include <unity.h>
+
+using namespace EncoderTool;
+using HAL::HostBoard;
+
+constexpr size_t ringSize = 64;
+static uint32_t ring[ringSize];
+static size_t head; // index the "DMA" writes next
+
+static void sample() // one DMA transfer: copies the simulated port into the ring
+{
+    ring[head] = HostBoard::port();
+    if (++head == ringSize) head = 0;
+}
+
+static const uint8_t pinsA[] = {2, 4, 9}, pinsB[] = {3, 5, 17}; // anywhere on the port
+static int gray[3];                                             // quarter steps applied to the pins
+
+static void turn(unsigned enc, int dir) // one quarter step (gray code)
+{
+    static const uint8_t seqA[] = {1, 1, 0, 0}, seqB[] = {1, 0, 0, 1};
+    gray[enc] += dir;
+    HostBoard::setPin(pinsA[enc], seqA[gray[enc] & 3]);
+    HostBoard::setPin(pinsB[enc], seqB[gray[enc] & 3]);
+}
+
+void setUp()
+{
+    head = 0;
+    for (unsigned i = 0; i < 3; i++)
+    {
+        gray[i] = 0;
+        HostBoard::setPin(pinsA[i], 1);
+        HostBoard::setPin(pinsB[i], 1);
+    }
+}
+
+void tearDown()
+{
+}
+
+void decodesRingFilledFromPins()
+{
+    PortSampler encoders(3, ring, ringSize);
+    for (unsigned i = 0; i < 3; i++) TEST_ASSERT_TRUE(encoders.setPins(i, pinsA[i], pinsB[i]));
+    TEST_ASSERT_TRUE(encoders.getPortRegister() == &HostBoard::port());
+    encoders.begin(CountMode::full, head);
+
+    srand(3);
+    for (int batch = 0; batch < 500; batch++) // wraps the ring many times
+    {
+        unsigned samples = 1 + rand() % (ringSize - 1); // never laps the decoder
+        for (unsigned s = 0; s < samples; s++)
+        {
+            if (rand() % 4 == 0) turn(rand() % 3, rand() % 3 == 0 ? -1 : 1); // at most one edge per encoder and sample
+            sample();
+        }
+        encoders.tick(head);
+    }
+
+    for (unsigned i = 0; i < 3; i++)
+    {
+        TEST_ASSERT_TRUE(gray[i] != 0);
+        TEST_ASSERT_EQUAL_INT(gray[i], encoders[i].getValue()); // full mode: one count per edge
+    }
+}
+
+void quietRingIsSkipped()
+{
+    static int calls;
+    calls = 0;
+
+    PortSampler encoders(3, ring, ringSize);
+    for (unsigned i = 0; i < 3; i++) encoders.setPins(i, pinsA[i], pinsB[i]);
+    encoders.begin(CountMode::quarter, head);
+    encoders.attachCallback([](uint_fast8_t, int, int) { calls++; });
+
+    HostBoard::setPin(20, 0); // other pins of the port are masked
+    for (unsigned s = 0; s < 2 * ringSize; s++)
+    {
+        HostBoard::setPin(20, s & 1);
+        sample();
+        if (s % 16 == 15) encoders.tick(head);
+    }
+    TEST_ASSERT_EQUAL_INT(0, calls);
+
+    for (int i = 0; i < 8; i++) // two detents, sampled between the edges
+    {
+        turn(1, 1);
+        sample();
+        sample();
+    }
+    encoders.tick(head);
+    TEST_ASSERT_EQUAL_INT(2, encoders[1].getValue());
+    TEST_ASSERT_EQUAL_INT(2, calls);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(decodesRingFilledFromPins);
+    RUN_TEST(quietRingIsSkipped);
+    return UNITY_END();
+}
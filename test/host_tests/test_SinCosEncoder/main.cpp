@@ -0,0 +1,73 @@
+#include "Analog/SinCosEncoder.h"
+#include <math.h>
+#include <stdio.h>
+#include <unity.h>
+
+using namespace EncoderTool;
+
+// CORDIC against the exact angle of the same (integer) vector, full circle in 1/65536 turn steps
+void atan2Error()
+{
+    for (int32_t amplitude : {16, 200, 2047, 1 << 20})
+    {
+        double maxErr = 0;
+        for (int32_t k = 0; k < 65536; k++)
+        {
+            double t  = k * 2 * M_PI / 65536;
+            int32_t y = lround(amplitude * sin(t)), x = lround(amplitude * cos(t));
+            double exact = atan2((double)y, (double)x) / (2 * M_PI) * 65536;
+            double err   = fabs(remainder(SinCosEncoder::atan2Turns(y, x) - exact, 65536.0));
+            if (err > maxErr) maxErr = err;
+        }
+
+        char msg[80];
+        snprintf(msg, sizeof(msg), "amplitude %ld: max error %.2f/65536 turn", (long)amplitude, maxErr);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_TRUE(maxErr <= 2.0);
+    }
+}
+
+void tracksPeriods()
+{
+    auto sample = [](double t, uint16_t& s, uint16_t& c) {
+        s = 2048 + lround(1500 * sin(t));
+        c = 2048 + lround(1500 * cos(t));
+    };
+
+    SinCosEncoder enc;
+    uint16_t s, c;
+    sample(0, s, c);
+    enc.begin(s, c, 256);
+
+    constexpr int N    = 10000;
+    const double total = 10.3 * 2 * M_PI; // 10.3 periods forward and back
+    for (int i = 1; i <= N; i++)
+    {
+        sample(total * i / N, s, c);
+        enc.update(s, c);
+    }
+    TEST_ASSERT_INT_WITHIN(1, 2636, enc.getValue()); // 10.3 * 256
+
+    for (int i = N - 1; i >= 0; i--)
+    {
+        sample(total * i / N, s, c);
+        enc.update(s, c);
+    }
+    TEST_ASSERT_INT_WITHIN(1, 0, enc.getValue());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(atan2Error);
+    RUN_TEST(tracksPeriods);
+    return UNITY_END();
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
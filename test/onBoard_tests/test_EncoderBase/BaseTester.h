@@ -1,24 +1,32 @@
 #pragma once
 #include "EncoderTool.h"
 
-class BaseTester : public EncoderTool::EncoderBase<int>
+template <typename counter_t>
+class BaseTester_tpl : public EncoderTool::EncoderBase<counter_t>
 {
+    using base = EncoderTool::EncoderBase<counter_t>;
+
  public:
     void begin(EncoderTool::CountMode mode)
     {
         curBin = 0b00;
-        EncoderBase::setCountMode(mode);
-        EncoderBase::begin(0, 0);
-        EncoderBase::setValue(0);
-        EncoderBase::setLimits(1,-1); //disable limits
+        base::setCountMode(mode);
+        base::begin(0, 0);
+        base::setLimits(1, -1); // disable limits
+        base::setStepSize(1);
+        base::setValue(0); // after removing the limits of previous tests, setValue() clamps
+        base::attachCallback(nullptr); // callbacks of previous tests capture their (gone) locals
+        base::setOutputMode(EncoderTool::OutputMode::position);
     }
 
+    EncoderTool::LimitMode getLimitMode() const { return base::profile->getLimitMode(); }
+
     void count(int n)
     {
         for (int i = 0; i < abs(n); i++)
         {
             n > 0 ? grayUp() : grayDown();
-            update(msb, lsb);
+            base::update(msb, lsb);
             // Serial.printf("%d %d\n", msb, lsb);
         }
     }
@@ -27,7 +35,7 @@ class BaseTester : public EncoderTool::EncoderBase<int>
     {
         for (int i = 0; i < 10; i++)
         {
-            update(msb, lsb, 1);
+            base::update(msb, lsb, 1);
             delay(10);
         }
     }
@@ -36,7 +44,7 @@ class BaseTester : public EncoderTool::EncoderBase<int>
     {
         for (int i = 0; i < 10; i++)
         {
-            update(msb, lsb, 0);
+            base::update(msb, lsb, 0);
             delay(10);
         }
     }
@@ -64,4 +72,6 @@ class BaseTester : public EncoderTool::EncoderBase<int>
         curBin &= 0b11;
         bin2Gray();
     }
-};
\ No newline at end of file
+};
+
+using BaseTester = BaseTester_tpl<int>;
@@ -1,9 +1,12 @@
 #include "BaseTester.h"
+#include "CompositeEncoder.h"
 #include <unity.h>
 
 using namespace EncoderTool;
 
 BaseTester EncoderBaseTester;
+BaseTester_tpl<Q16_16> FixedTester;
+BaseTester_tpl<int8_t> Int8Tester;
 
 void SetGetValue()
 {
@@ -107,6 +110,363 @@ void ButtonTesting()
     TEST_ASSERT_EQUAL(0, EncoderBaseTester.getButton());
 }
 
+void StepSize()
+{
+    EncoderBaseTester.begin(CountMode::full);
+    EncoderBaseTester.setStepSize(5);
+
+    EncoderBaseTester.count(3);
+    TEST_ASSERT_EQUAL_INT(15, EncoderBaseTester.getValue());
+
+    EncoderBaseTester.count(-4);
+    TEST_ASSERT_EQUAL_INT(-5, EncoderBaseTester.getValue());
+}
+
+void FixedPointStepSize()
+{
+    FixedTester.begin(CountMode::full);
+    FixedTester.setStepSize(0.25);
+    FixedTester.setLimits(-1, 2);
+
+    FixedTester.count(3);
+    TEST_ASSERT_EQUAL_FLOAT(0.75f, FixedTester.getValue().toFloat());
+
+    FixedTester.count(20); // clamped at max
+    TEST_ASSERT_TRUE(FixedTester.getValue() == Q16_16(2));
+
+    FixedTester.setValue(0);
+    FixedTester.setStepSize(0.05); // not exactly representable, steps add up the raw value
+    FixedTester.count(20);
+    TEST_ASSERT_EQUAL_INT32(20 * Q16_16(0.05).getRaw(), FixedTester.getValue().getRaw());
+}
+
+void SubStepPosition()
+{
+    EncoderBaseTester.begin(CountMode::quarterInv); // starts on a detent (inputs 0/0)
+    EncoderBaseTester.count(3);
+    TEST_ASSERT_EQUAL_INT(0, EncoderBaseTester.getValue());
+    TEST_ASSERT_EQUAL_INT(3, EncoderBaseTester.getSubStepPosition());
+
+    EncoderBaseTester.count(1);
+    TEST_ASSERT_EQUAL_INT(4, EncoderBaseTester.getSubStepPosition());
+}
+
+void SubStepPositionStepSize()
+{
+    EncoderBaseTester.begin(CountMode::half);
+    EncoderBaseTester.setStepSize(10);
+
+    const int expected[] = {20, 40, 60, 80}; // value * 4 + fraction * step size
+    for (int pos : expected)
+    {
+        EncoderBaseTester.count(1);
+        TEST_ASSERT_EQUAL_INT(pos, EncoderBaseTester.getSubStepPosition());
+    }
+    TEST_ASSERT_EQUAL_INT(20, EncoderBaseTester.getValue());
+}
+
+void UnboundedMode()
+{
+    Int8Tester.begin(CountMode::full);
+    TEST_ASSERT_TRUE(Int8Tester.getLimitMode() == LimitMode::unbounded);
+
+    Int8Tester.setValue(126);
+    Int8Tester.count(3); // wraps at the end of the counter type
+    TEST_ASSERT_EQUAL_INT(-127, Int8Tester.getValue());
+
+    Int8Tester.setLimits(-128, 127); // full range, no limits
+    TEST_ASSERT_TRUE(Int8Tester.getLimitMode() == LimitMode::unbounded);
+    Int8Tester.count(-2);
+    TEST_ASSERT_EQUAL_INT(127, Int8Tester.getValue());
+}
+
+void ClampedMode()
+{
+    int d = 0;
+    EncoderBaseTester.begin(CountMode::full);
+    EncoderBaseTester.setLimits(0, 12);
+    EncoderBaseTester.setStepSize(5);
+    EncoderBaseTester.attachCallback([&d](int value, int delta) { d = delta; });
+    TEST_ASSERT_TRUE(EncoderBaseTester.getLimitMode() == LimitMode::clamped);
+
+    EncoderBaseTester.count(2);
+    TEST_ASSERT_EQUAL_INT(10, EncoderBaseTester.getValue());
+    EncoderBaseTester.count(1); // partial step to the limit, reports the actual change
+    TEST_ASSERT_EQUAL_INT(12, EncoderBaseTester.getValue());
+    TEST_ASSERT_EQUAL_INT(2, d);
+
+    d = 0;
+    EncoderBaseTester.count(1); // at the limit, no callback
+    TEST_ASSERT_EQUAL_INT(12, EncoderBaseTester.getValue());
+    TEST_ASSERT_EQUAL_INT(0, d);
+
+    EncoderBaseTester.count(-4);
+    TEST_ASSERT_EQUAL_INT(0, EncoderBaseTester.getValue());
+
+    Int8Tester.begin(CountMode::full); // limits at the ends of the counter type, value + delta would overflow
+    Int8Tester.setLimits(-100, 127);
+    Int8Tester.setStepSize(100);
+    Int8Tester.count(2);
+    TEST_ASSERT_EQUAL_INT(127, Int8Tester.getValue());
+    Int8Tester.count(-3);
+    TEST_ASSERT_EQUAL_INT(-100, Int8Tester.getValue());
+}
+
+void ClampedSetValue()
+{
+    EncoderBaseTester.begin(CountMode::full);
+    EncoderBaseTester.setLimits(-5, 10);
+
+    EncoderBaseTester.setValue(42);
+    TEST_ASSERT_EQUAL_INT(10, EncoderBaseTester.getValue());
+    EncoderBaseTester.setValue(-42);
+    TEST_ASSERT_EQUAL_INT(-5, EncoderBaseTester.getValue());
+
+    EncoderBaseTester.setLimits(0, 3); // moves the value into the new range
+    TEST_ASSERT_EQUAL_INT(0, EncoderBaseTester.getValue());
+
+    EncoderBaseTester.setLimits(0, 3, true); // periodic limits clamp as well
+    EncoderBaseTester.setValue(7);
+    TEST_ASSERT_EQUAL_INT(3, EncoderBaseTester.getValue());
+}
+
+void PeriodicMode()
+{
+    EncoderBaseTester.begin(CountMode::full);
+    EncoderBaseTester.setLimits(0, 10, true);
+    EncoderBaseTester.setStepSize(5);
+    TEST_ASSERT_TRUE(EncoderBaseTester.getLimitMode() == LimitMode::periodic);
+
+    const int expected[] = {5, 10, 0, 5}; // the wrap from max to min is one step
+    for (int v : expected)
+    {
+        EncoderBaseTester.count(1);
+        TEST_ASSERT_EQUAL_INT(v, EncoderBaseTester.getValue());
+    }
+    EncoderBaseTester.count(-2);
+    TEST_ASSERT_EQUAL_INT(10, EncoderBaseTester.getValue());
+
+    EncoderBaseTester.setValue(8); // off grid: a partial step beyond max ends at min
+    EncoderBaseTester.count(1);
+    TEST_ASSERT_EQUAL_INT(0, EncoderBaseTester.getValue());
+
+    FixedTester.begin(CountMode::full);
+    FixedTester.setLimits(0, 1, true);
+    FixedTester.setStepSize(0.25); // period 1.25
+    TEST_ASSERT_TRUE(FixedTester.getLimitMode() == LimitMode::periodic);
+    FixedTester.count(4);
+    TEST_ASSERT_TRUE(FixedTester.getValue() == Q16_16(1));
+    FixedTester.count(1);
+    TEST_ASSERT_TRUE(FixedTester.getValue() == Q16_16(0));
+    FixedTester.count(5 * 7 + 2); // stays on the grid over many periods
+    TEST_ASSERT_TRUE(FixedTester.getValue() == Q16_16(0.5));
+    FixedTester.count(-3);
+    TEST_ASSERT_TRUE(FixedTester.getValue() == Q16_16(1));
+
+    Int8Tester.begin(CountMode::full); // range wider than half the counter type
+    Int8Tester.setLimits(-100, 100, true);
+    Int8Tester.setValue(99);
+    Int8Tester.count(3);
+    TEST_ASSERT_EQUAL_INT(-99, Int8Tester.getValue());
+}
+
+void PeriodicPow2Mode()
+{
+    EncoderBaseTester.begin(CountMode::full);
+    EncoderBaseTester.setLimits(0, 255, true);
+    TEST_ASSERT_TRUE(EncoderBaseTester.getLimitMode() == LimitMode::periodicPow2);
+    EncoderBaseTester.count(-1);
+    TEST_ASSERT_EQUAL_INT(255, EncoderBaseTester.getValue());
+
+    EncoderBaseTester.setLimits(2, 8, true);
+    EncoderBaseTester.setStepSize(2); // period 8
+    TEST_ASSERT_TRUE(EncoderBaseTester.getLimitMode() == LimitMode::periodicPow2);
+    EncoderBaseTester.setValue(2);
+    const int expected[] = {4, 6, 8, 2, 4};
+    for (int v : expected)
+    {
+        EncoderBaseTester.count(1);
+        TEST_ASSERT_EQUAL_INT(v, EncoderBaseTester.getValue());
+    }
+    EncoderBaseTester.count(-2);
+    TEST_ASSERT_EQUAL_INT(8, EncoderBaseTester.getValue());
+
+    EncoderBaseTester.setValue(7); // off grid: a partial step beyond max ends at min
+    EncoderBaseTester.count(1);
+    TEST_ASSERT_EQUAL_INT(2, EncoderBaseTester.getValue());
+
+    EncoderBaseTester.setStepSize(3); // period 9
+    TEST_ASSERT_TRUE(EncoderBaseTester.getLimitMode() == LimitMode::periodic);
+
+    Int8Tester.begin(CountMode::full); // 128 values, the period doesn't fit into the counter type
+    Int8Tester.setLimits(0, 127, true);
+    TEST_ASSERT_TRUE(Int8Tester.getLimitMode() == LimitMode::periodicPow2);
+    Int8Tester.setValue(126);
+    Int8Tester.count(3);
+    TEST_ASSERT_EQUAL_INT(1, Int8Tester.getValue());
+
+    FixedTester.begin(CountMode::full);
+    FixedTester.setLimits(0, 0.75, true);
+    FixedTester.setStepSize(0.25); // period 1
+    TEST_ASSERT_TRUE(FixedTester.getLimitMode() == LimitMode::periodicPow2);
+    FixedTester.count(3);
+    TEST_ASSERT_TRUE(FixedTester.getValue() == Q16_16(0.75));
+    FixedTester.count(1);
+    TEST_ASSERT_TRUE(FixedTester.getValue() == Q16_16(0));
+}
+
+void VirtualDetents()
+{
+    int calls = 0, last = 0;
+    EncoderBaseTester.begin(CountMode::full);
+    EncoderBaseTester.setDetents(4); // threshold: half a detent
+    EncoderBaseTester.attachCallback([&calls, &last](int detent, int delta) { calls++; last = detent; });
+
+    EncoderBaseTester.count(2);
+    TEST_ASSERT_EQUAL_INT(0, calls); // nothing reported between the detents
+    TEST_ASSERT_EQUAL_INT(2, EncoderBaseTester.getValue());
+
+    EncoderBaseTester.count(1);
+    TEST_ASSERT_EQUAL_INT(1, calls);
+    TEST_ASSERT_EQUAL_INT(1, last);
+    TEST_ASSERT_EQUAL_INT(1, EncoderBaseTester.getDetent());
+
+    EncoderBaseTester.count(8);
+    TEST_ASSERT_EQUAL_INT(3, EncoderBaseTester.getDetent());
+    TEST_ASSERT_EQUAL_INT(11, EncoderBaseTester.getValue()); // value keeps the full resolution
+
+    EncoderBaseTester.count(-11);
+    TEST_ASSERT_EQUAL_INT(0, last);
+    TEST_ASSERT_EQUAL_INT(0, EncoderBaseTester.getDetent());
+}
+
+void DetentHysteresis()
+{
+    int calls = 0;
+    EncoderBaseTester.begin(CountMode::full);
+    EncoderBaseTester.setDetents(4, 1); // threshold 3 counts
+    EncoderBaseTester.attachCallback([&calls](int detent, int delta) { calls++; });
+
+    EncoderBaseTester.count(3);
+    TEST_ASSERT_EQUAL_INT(0, calls);
+    EncoderBaseTester.count(1);
+    TEST_ASSERT_EQUAL_INT(1, calls);
+
+    for (int i = 0; i < 10; i++) // chatter at the detent edge
+    {
+        EncoderBaseTester.count(-1);
+        EncoderBaseTester.count(1);
+    }
+    TEST_ASSERT_EQUAL_INT(1, calls);
+    TEST_ASSERT_EQUAL_INT(1, EncoderBaseTester.getDetent());
+
+    EncoderBaseTester.setStepSize(10); // thresholds scale with the step size
+    EncoderBaseTester.count(3);
+    TEST_ASSERT_EQUAL_INT(1, EncoderBaseTester.getDetent());
+    EncoderBaseTester.count(1);
+    TEST_ASSERT_EQUAL_INT(2, EncoderBaseTester.getDetent());
+}
+
+void SharedProfile()
+{
+    static EncoderProfile profile; // needs to outlive the encoder's use of it
+    profile.setLimits(0, 5);
+
+    EncoderBaseTester.begin(CountMode::quarter);
+    EncoderBaseTester.setProfile(profile); // no count mode in the profile, stays quarter
+    EncoderBaseTester.count(8);
+    TEST_ASSERT_EQUAL_INT(2, EncoderBaseTester.getValue());
+    EncoderBaseTester.count(40);
+    TEST_ASSERT_EQUAL_INT(5, EncoderBaseTester.getValue());
+
+    EncoderBaseTester.setStepSize(2); // private copy, the shared profile stays unchanged
+    TEST_ASSERT_EQUAL_INT(5, EncoderBaseTester.getValue());
+    TEST_ASSERT_TRUE(profile.getLimitMode() == LimitMode::clamped);
+}
+
+void ProfileCountMode()
+{
+    static EncoderProfile profile;
+    profile.setCountMode(CountMode::full);
+
+    EncoderBaseTester.begin(CountMode::quarter); // inverted inputs
+    EncoderBaseTester.count(1);                   // between two detents
+    EncoderBaseTester.setProfile(profile);        // re-seeds the state for the new inversion
+    EncoderBaseTester.count(4);
+    TEST_ASSERT_EQUAL_INT(4, EncoderBaseTester.getValue());
+
+    EncoderBaseTester.setLimits(1, -1); // the count mode stays with the encoder
+    EncoderBaseTester.count(-3);
+    TEST_ASSERT_EQUAL_INT(1, EncoderBaseTester.getValue());
+}
+
+void VelocityOutput()
+{
+    int v = -1;
+    EncoderBaseTester.begin(CountMode::full);
+    EncoderBaseTester.setOutputMode(OutputMode::velocity, 4);
+    EncoderBaseTester.attachCallback([&v](int velocity, int delta) { v = velocity; });
+
+    EncoderBaseTester.count(100); // steps don't decay the velocity, only ticks do
+    TEST_ASSERT_EQUAL_INT32(100 * 256, EncoderBaseTester.getVelocity());
+    TEST_ASSERT_EQUAL_INT(100, v); // callback reports steps
+
+    for (int i = 0; i < 1000 && v != 0; i++) EncoderBaseTester.decayVelocity();
+    TEST_ASSERT_EQUAL_INT(0, v);
+    TEST_ASSERT_EQUAL_INT32(0, EncoderBaseTester.getVelocity());
+}
+
+void VelocityOutputFixed()
+{
+    Q16_16 v = -1;
+    FixedTester.begin(CountMode::full);
+    FixedTester.setOutputMode(OutputMode::velocity, 4);
+    FixedTester.attachCallback([&v](Q16_16 velocity, Q16_16 delta) { v = velocity; });
+
+    FixedTester.count(1);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, v.toFloat());
+
+    FixedTester.decayVelocity(); // 256 - 256/16
+    FixedTester.count(1);
+    TEST_ASSERT_EQUAL_FLOAT(1.9375f, v.toFloat()); // fraction kept
+
+    FixedTester.count(200000); // way beyond the integer range of Q16_16
+    TEST_ASSERT_TRUE(v == std::numeric_limits<Q16_16>::max());
+}
+
+void VelocityOutputInt8()
+{
+    int8_t v = 0;
+    Int8Tester.begin(CountMode::full);
+    Int8Tester.setOutputMode(OutputMode::velocity);
+    Int8Tester.attachCallback([&v](int8_t velocity, int8_t delta) { v = velocity; });
+
+    Int8Tester.count(1);
+    TEST_ASSERT_EQUAL_INT(1, v);
+    Int8Tester.count(200); // saturates instead of wrapping
+    TEST_ASSERT_EQUAL_INT(127, v);
+    Int8Tester.count(-400);
+    TEST_ASSERT_EQUAL_INT(-128, v);
+}
+
+void CompositeSourceDestroyed()
+{
+    CompositeEncoder composite;
+    {
+        BaseTester fine;
+        fine.begin(CountMode::full);
+        composite.addSource(fine);
+        composite.setModifierButton(fine);
+        fine.count(3);
+        TEST_ASSERT_EQUAL_INT(3, composite.getValue());
+    } // fine detaches itself, the composite must not use it anymore
+
+    EncoderBaseTester.begin(CountMode::full);
+    TEST_ASSERT_TRUE(composite.addSource(EncoderBaseTester, 10)); // takes the freed slot
+    EncoderBaseTester.count(2);
+    TEST_ASSERT_EQUAL_INT(23, composite.getValue());
+    composite.removeSource(EncoderBaseTester);
+}
 
 int main(int argc, char** argv)
 {
@@ -123,6 +483,23 @@ int main(int argc, char** argv)
     RUN_TEST(LimitCounting);
     RUN_TEST(valueCallbacks);
     RUN_TEST(ButtonTesting);
+    RUN_TEST(StepSize);
+    RUN_TEST(FixedPointStepSize);
+    RUN_TEST(SubStepPosition);
+    RUN_TEST(SubStepPositionStepSize);
+    RUN_TEST(UnboundedMode);
+    RUN_TEST(ClampedMode);
+    RUN_TEST(ClampedSetValue);
+    RUN_TEST(PeriodicMode);
+    RUN_TEST(PeriodicPow2Mode);
+    RUN_TEST(VirtualDetents);
+    RUN_TEST(DetentHysteresis);
+    RUN_TEST(SharedProfile);
+    RUN_TEST(ProfileCountMode);
+    RUN_TEST(VelocityOutput);
+    RUN_TEST(VelocityOutputFixed);
+    RUN_TEST(VelocityOutputInt8);
+    RUN_TEST(CompositeSourceDestroyed);
 
     UNITY_END();
 }
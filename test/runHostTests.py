@@ -0,0 +1,3 @@
+import subprocess
+
+result = subprocess.run(["pio", "test", "-ctest/cfgRunUnitTests.ini", "-enative"])